@@ -1,11 +1,14 @@
 ﻿/*
   ==============================================================================
     FDN_DSP.h
-    Phase 188: Fix Compilation Errors (ratioSum)
-
-    FIXES:
-    - Restored 'ratioSum' calculation in updatePhysics.
-    - Ensured robust compilation for SFX logic.
+    Phase 212: Measured Decay
+
+    UPDATES:
+    - PhysicsParams: the updatePhysics() arguments (plus diffusion length
+      and ER order) as one struct, with an updatePhysics overload taking it.
+    - DecayAnalyzer: renders the impulse response of a PhysicsParams
+      snapshot on a private engine at idle priority and fits EDT / T20 /
+      T30 per octave band to Schroeder decay curves. Cached per snapshot.
   ==============================================================================
 */
 
@@ -16,22 +19,97 @@
 #include <algorithm>
 #include <random>
 #include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <complex>
+#include <chrono>
+#include <thread>
+#include <condition_variable>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include "FDN_Memory.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FDN_HAS_SSE2 1
+#include <emmintrin.h>
+#else
+#define FDN_HAS_SSE2 0
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#include <pthread.h>
+#include <sys/qos.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+#if FDN_HAS_SSE2 || (defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__)))
+#define FDN_HARDWARE_FTZ 1
+#else
+#define FDN_HARDWARE_FTZ 0
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define FDN_HAS_RDTSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define FDN_HAS_RDTSC 0
+#endif
+
+// Per-stage profiling build switch; see StageProfiler.
+#ifndef FDN_PROFILE
+#define FDN_PROFILE 0
+#endif
+#if FDN_PROFILE
+#define FDN_PROFILE_START(timeline) (timeline).start()
+#define FDN_PROFILE_LAP(timeline, stage) (timeline).lap(StageProfiler::stage)
+#else
+#define FDN_PROFILE_START(timeline) ((void)0)
+#define FDN_PROFILE_LAP(timeline, stage) ((void)0)
+#endif
 
 // ==============================================================================
 // 1. CONSTANTS & UTILITIES
 // ==============================================================================
 
 static constexpr float MAX_DELAY_SECONDS = 10.0f;
+static constexpr float MAX_PREDELAY_SECONDS = 0.5f;
+static constexpr float MAX_ER_PATH_SECONDS = 3.0f; // 300 m room diagonal with margin
 static constexpr float PI = 3.14159265359f;
 static constexpr float PI_2 = 6.28318530718f;
 static constexpr float HALF_PI = 1.570796327f;
 static constexpr float SPEED_OF_SOUND = 343.0f;
 static constexpr int FDN_CHANNELS = 16;
+static constexpr int PROCESS_BLOCK = 256; // feed-forward stages run in chunks of this size
 static constexpr float HARD_CLIP_THRESHOLD = 2.0f;
 
 static constexpr float REFERENCE_SAMPLE_RATE = 48000.0f;
 static constexpr float STEREO_SPREAD_MS = 0.5f;
 
+// Long delay lines are backed by huge pages when the OS allows it.
+using LargeFloatBuffer = std::vector<float, FDNMemory::HugePageAllocator<float>>;
+
 static constexpr float LFO_RATIOS[16] = {
     1.000f, 0.618f, 1.272f, 0.786f, 1.618f, 0.382f, 1.414f, 0.528f,
     1.175f, 0.854f, 1.324f, 0.472f, 1.089f, 0.927f, 1.236f, 0.691f
@@ -39,46 +117,300 @@ static constexpr float LFO_RATIOS[16] = {
 
 // --- Helper Functions ---
 
+// --- Denormal Policy ---
+// Recursive filters and feedback lines decay into the subnormal range, where
+// x86 and many ARM cores take a microcode assist per operation. The engine
+// flushes them in hardware for the whole of process(); antiDenormal is only
+// needed where no such mode exists.
+class ScopedFlushDenormals {
+#if FDN_HAS_SSE2
+    unsigned int saved;
+public:
+    ScopedFlushDenormals() : saved(_mm_getcsr()) { _mm_setcsr(saved | 0x8040u); } // FTZ | DAZ
+    ~ScopedFlushDenormals() { _mm_setcsr(saved); }
+#elif FDN_HARDWARE_FTZ
+    uint64_t saved;
+public:
+    ScopedFlushDenormals() {
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(saved));
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(saved | (uint64_t(1) << 24))); // FZ
+    }
+    ~ScopedFlushDenormals() { __asm__ __volatile__("msr fpcr, %0" : : "r"(saved)); }
+#else
+public:
+    ScopedFlushDenormals() = default;
+#endif
+    ScopedFlushDenormals(const ScopedFlushDenormals&) = delete;
+    ScopedFlushDenormals& operator=(const ScopedFlushDenormals&) = delete;
+};
+
 inline float antiDenormal(float x) {
+#if FDN_HARDWARE_FTZ
+    return x;
+#else
     return (std::abs(x) < 1.0e-20f) ? 0.0f : x;
+#endif
+}
+
+// --- Thread Priority ---
+// Applies to the calling thread, so helper threads set it first thing in
+// their own loop (macOS QoS classes can only be set that way). Best effort:
+// a refused request leaves the thread where it was.
+// AudioHelper is raised but never realtime: the audio thread may itself not
+// be realtime (offline renders, the engine library), and a realtime helper
+// spinning on a barrier would starve it on a shared core.
+enum class ThreadPriority {
+    Background,  // only runs when nothing else wants the core
+    AudioHelper, // does part of the audio callback's work
+};
+
+inline void setCurrentThreadPriority(ThreadPriority priority) {
+    const bool audio = priority == ThreadPriority::AudioHelper;
+#if defined(__linux__)
+    if (audio) {
+        // Per thread on Linux; below nice 0 needs CAP_SYS_NICE or RLIMIT_NICE.
+        setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), -10);
+    }
+    else {
+        sched_param param{};
+        pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+    }
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(audio ? QOS_CLASS_USER_INTERACTIVE : QOS_CLASS_BACKGROUND, 0);
+#elif defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), audio ? THREAD_PRIORITY_HIGHEST : THREAD_PRIORITY_IDLE);
+#else
+    (void)audio;
+#endif
+}
+
+// Counting semaphore whose post() never takes a lock, so the audio thread
+// can wake a sleeping helper. The OS call is only made when someone waits.
+class WakeSemaphore {
+public:
+#if defined(__linux__)
+    WakeSemaphore() { sem_init(&sem, 0, 0); }
+    ~WakeSemaphore() { sem_destroy(&sem); }
+    void post() { sem_post(&sem); }
+    void wait() { while (sem_wait(&sem) != 0) {} } // EINTR
+#elif defined(__APPLE__)
+    WakeSemaphore() : sem(dispatch_semaphore_create(0)) {}
+    ~WakeSemaphore() { dispatch_release(sem); }
+    void post() { dispatch_semaphore_signal(sem); }
+    void wait() { dispatch_semaphore_wait(sem, DISPATCH_TIME_FOREVER); }
+#elif defined(_WIN32)
+    WakeSemaphore() : sem(CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr)) {}
+    ~WakeSemaphore() { CloseHandle(sem); }
+    void post() { ReleaseSemaphore(sem, 1, nullptr); }
+    void wait() { WaitForSingleObject(sem, INFINITE); }
+#else
+    // No lock-free primitive here; post() locks.
+    void post() {
+        { std::lock_guard<std::mutex> guard(lock); ++count; }
+        cv.notify_one();
+    }
+    void wait() {
+        std::unique_lock<std::mutex> guard(lock);
+        cv.wait(guard, [this] { return count > 0; });
+        --count;
+    }
+#endif
+    WakeSemaphore(const WakeSemaphore&) = delete;
+    WakeSemaphore& operator=(const WakeSemaphore&) = delete;
+
+private:
+#if defined(__linux__)
+    sem_t sem;
+#elif defined(__APPLE__)
+    dispatch_semaphore_t sem;
+#elif defined(_WIN32)
+    HANDLE sem;
+#else
+    std::mutex lock;
+    std::condition_variable cv;
+    int count = 0;
+#endif
+};
+
+// Epoch clearing: a ring buffer that has only written 'valid' samples since
+// its last reset treats everything further back than that as zero.
+template <typename Buffer>
+inline float epochRead(const Buffer& buffer, int size, int idx, int writePos, int valid) {
+    int distance = writePos - idx;
+    if (distance <= 0) distance += size;
+    return (distance > valid) ? 0.0f : buffer[idx];
 }
 
 inline float hardClip(float x) {
     return std::clamp(x, -HARD_CLIP_THRESHOLD, HARD_CLIP_THRESHOLD);
 }
 
+// Pade [7/6] tanh, clamped where the approximant reaches 1.
+// Absolute error < 1e-4 everywhere.
+inline float fastTanh(float x) {
+    x = std::clamp(x, -4.97f, 4.97f);
+    float x2 = x * x;
+    float num = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+    float den = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + 28.0f * x2));
+    return std::max(-1.0f, std::min(num / den, 1.0f));
+}
+
 inline float softSaturate(float x, float drive) {
     if (drive < 0.001f) return x;
     float driveAmount = drive * 4.0f;
     float shaped = x * (1.0f + driveAmount);
-    float saturated = std::tanh(shaped);
+    float saturated = fastTanh(shaped);
     return saturated / (1.0f + driveAmount);
 }
 
+// softSaturate over a run of values (the 16 line inputs), four at a time with SSE2.
+inline void softSaturateLines(float* x, int count, float drive) {
+    if (drive < 0.001f) return;
+    const float k = 1.0f + drive * 4.0f;
+    const float invK = 1.0f / k;
+    int i = 0;
+#if FDN_HAS_SSE2
+    const __m128 vk = _mm_set1_ps(k), vInvK = _mm_set1_ps(invK);
+    const __m128 lim = _mm_set1_ps(4.97f), one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(x + i), vk);
+        v = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), lim), _mm_min_ps(v, lim));
+        const __m128 v2 = _mm_mul_ps(v, v);
+        __m128 num = _mm_add_ps(_mm_set1_ps(378.0f), v2);
+        num = _mm_add_ps(_mm_set1_ps(17325.0f), _mm_mul_ps(v2, num));
+        num = _mm_mul_ps(v, _mm_add_ps(_mm_set1_ps(135135.0f), _mm_mul_ps(v2, num)));
+        __m128 den = _mm_add_ps(_mm_set1_ps(3150.0f), _mm_mul_ps(_mm_set1_ps(28.0f), v2));
+        den = _mm_add_ps(_mm_set1_ps(62370.0f), _mm_mul_ps(v2, den));
+        den = _mm_add_ps(_mm_set1_ps(135135.0f), _mm_mul_ps(v2, den));
+        __m128 t = _mm_div_ps(num, den);
+        t = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), one), _mm_min_ps(t, one));
+        _mm_storeu_ps(x + i, _mm_mul_ps(t, vInvK));
+    }
+#endif
+    for (; i < count; ++i) x[i] = fastTanh(x[i] * k) * invK;
+}
+
+// log2 from the float's exponent plus a quartic on the mantissa (|error| < 2e-4).
+inline float fastLog2(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    const float e = (float)((int)((bits >> 23) & 255u) - 127);
+    bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+    float m;
+    std::memcpy(&m, &bits, sizeof(m));
+    const float t = m - 1.0f;
+    return e + t * (1.4385468f + t * (-0.67808149f + t * (0.32363037f + t * -0.084285093f)));
+}
+
+// 2^p from a cubic on the fraction, added into the exponent (relative error < 2e-4).
+inline float fastPow2(float p) {
+    p = std::clamp(p, -126.0f, 126.0f);
+    const float fi = std::floor(p);
+    const float f = p - fi;
+    float r = 1.0f + f * (0.69583356f + f * (0.22606716f + f * 0.078024521f));
+    uint32_t bits;
+    std::memcpy(&bits, &r, sizeof(bits));
+    bits += (uint32_t)((int32_t)fi) << 23;
+    std::memcpy(&r, &bits, sizeof(r));
+    return r;
+}
+
 inline float safeLoopSaturate(float x) {
-    if (x > 1.5f) return 1.5f + std::tanh(x - 1.5f) * 0.1f;
-    if (x < -1.5f) return -1.5f + std::tanh(x + 1.5f) * 0.1f;
+    if (x > 1.5f) return 1.5f + fastTanh(x - 1.5f) * 0.1f;
+    if (x < -1.5f) return -1.5f + fastTanh(x + 1.5f) * 0.1f;
     return x;
 }
 
+// softSaturate with first-order antiderivative anti-aliasing:
+// y = (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1]), F(x) = log(cosh(k x)) / k^2.
+// Adds half a sample of delay. F is kept in double to survive the division.
+class SaturatorADAA {
+    float x1 = 0.0f;
+    double F1 = 0.0;
+    static double logCosh(double v) {
+        double a = std::abs(v);
+        return a + std::log1p(std::exp(-2.0 * a)) - 0.69314718055994531;
+    }
+public:
+    void reset() { x1 = 0.0f; F1 = 0.0; }
+    inline float process(float x, float drive) {
+        const float k = 1.0f + drive * 4.0f;
+        const double F = logCosh((double)x * k) / ((double)k * k);
+        const float dx = x - x1;
+        float y;
+        if (std::abs(dx) > 1.0e-5f) y = (float)((F - F1) / (double)dx);
+        else y = fastTanh(0.5f * (x + x1) * k) / k;
+        x1 = x;
+        F1 = F;
+        return y;
+    }
+};
+
+inline bool isPrimeTrialDivision(int num) {
+    if (num <= 1) return false;
+    if (num <= 3) return true;
+    if (num % 2 == 0 || num % 3 == 0) return false;
+    for (int i = 5; (int64_t)i * i <= num; i += 6)
+        if (num % i == 0 || num % (i + 2) == 0) return false;
+    return true;
+}
+
+// Odd-only sieve of Eratosthenes up to LIMIT, covering MAX_DELAY_SECONDS at
+// 768 kHz. Bit k is set when 2k+1 is prime. No prime gap below LIMIT is wider
+// than 154, so a nearest-prime query tests at most ~155 candidates.
+class PrimeSieve {
+    std::vector<uint64_t> oddBits;
+public:
+    static constexpr int LIMIT = 1 << 23;
+
+    PrimeSieve() : oddBits((size_t)LIMIT / 128, ~uint64_t(0)) {
+        clear(1);
+        for (int i = 3; i * i < LIMIT; i += 2) {
+            if (!isPrime(i)) continue;
+            for (int m = i * i; m < LIMIT; m += 2 * i) clear(m);
+        }
+    }
+
+    bool isPrime(int n) const {
+        if (n < 2) return false;
+        if ((n & 1) == 0) return n == 2;
+        const int k = n >> 1;
+        return (oddBits[(size_t)k >> 6] >> (k & 63)) & 1u;
+    }
+
+    // Built on first use; engines touch it from prepare() so the audio thread
+    // never pays for the sieve.
+    static const PrimeSieve& instance() {
+        static const PrimeSieve sieve;
+        return sieve;
+    }
+
+private:
+    void clear(int n) {
+        const int k = n >> 1;
+        oddBits[(size_t)k >> 6] &= ~(uint64_t(1) << (k & 63));
+    }
+};
+
 inline int findNearestPrime(int n) {
-    auto isPrime = [](int num) {
-        if (num <= 1) return false;
-        if (num <= 3) return true;
-        if (num % 2 == 0 || num % 3 == 0) return false;
-        for (int i = 5; i * i <= num; i += 6)
-            if (num % i == 0 || num % (i + 2) == 0) return false;
-        return true;
-        };
     if (n <= 2) return 2;
+    if (n < PrimeSieve::LIMIT - 1024) {
+        const PrimeSieve& sieve = PrimeSieve::instance();
+        int up = n;
+        while (!sieve.isPrime(up)) up++;
+        int down = n;
+        while (down > 2 && !sieve.isPrime(down)) down--;
+        return ((up - n) < (n - down)) ? up : down;
+    }
     int up = n;
-    while (!isPrime(up)) up++;
+    while (!isPrimeTrialDivision(up)) up++;
     int down = n;
-    while (down > 2 && !isPrime(down)) down--;
+    while (down > 2 && !isPrimeTrialDivision(down)) down--;
     return ((up - n) < (n - down)) ? up : down;
 }
 
-static float calcAirAbsorption(float freq, float tempC, float humidity) {
+// Analytic attenuation in dB per metre.
+static float calcAirAttenuationDb(float freq, float tempC, float humidity) {
     float safeTemp = std::clamp(tempC, -50.0f, 100.0f);
     float safeHum = std::clamp(humidity, 1.0f, 100.0f);
     float T = safeTemp + 273.15f;
@@ -100,10 +432,227 @@ static float calcAirAbsorption(float freq, float tempC, float humidity) {
             )
         );
     alpha *= 100.0f;
-    if (std::isnan(alpha) || std::isinf(alpha)) return 1.0f;
-    return std::pow(10.0f, -alpha / 20.0f);
+    if (std::isnan(alpha) || std::isinf(alpha)) return 0.0f;
+    return alpha;
 }
 
+// --- Shared Read-Only Tables ---
+// Tables that only depend on their key are built once per process and shared
+// by every instance. The cache holds weak references, so a table is freed when
+// the last instance using it goes away.
+namespace SharedTables {
+    template <typename Key, typename Value>
+    class Cache {
+        std::mutex lock;
+        std::map<Key, std::weak_ptr<const Value>> entries;
+    public:
+        template <typename Factory>
+        std::shared_ptr<const Value> get(const Key& key, Factory&& build) {
+            std::lock_guard<std::mutex> guard(lock);
+            auto& slot = entries[key];
+            if (auto existing = slot.lock()) return existing;
+            auto created = std::make_shared<const Value>(build());
+            slot = created;
+            return created;
+        }
+    };
+
+    template <typename Key, typename Value>
+    Cache<Key, Value>& instance() {
+        static Cache<Key, Value> cache;
+        return cache;
+    }
+}
+
+// --- Air Absorption Table ---
+// calcAirAttenuationDb sampled on a 5 degC x 3 %RH grid for the six decay
+// bands. The attenuation is smooth enough over that grid that bilinear
+// interpolation stays within a few 1e-6 dB/m of the analytic model; build()
+// measures this at every cell centre, keeps the result in maxErrorDb and
+// asserts it is under MAX_ERROR_DB.
+// Values are stored as log2 gain per metre so a path of mfp metres is one
+// exp2(mfp * g) instead of pow(10, ...) followed by pow(..., mfp).
+struct AirAbsorptionTable {
+    static constexpr int NUM_BANDS = 6;
+    static constexpr float TEMP_MIN = -50.0f, TEMP_MAX = 100.0f, TEMP_STEP = 5.0f;
+    static constexpr float HUM_MIN = 1.0f, HUM_MAX = 100.0f, HUM_STEP = 3.0f;
+    static constexpr int NUM_TEMP = 31;
+    static constexpr int NUM_HUM = 34;
+    static constexpr float BAND_FREQS[NUM_BANDS] = { 125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f };
+    static constexpr float DB_TO_LOG2 = -0.16609640474f; // -log2(10) / 20
+    static constexpr float MAX_ERROR_DB = 1.0e-4f;       // per metre; measured ~4e-6
+
+    using Bands = std::array<float, NUM_BANDS>;
+    std::vector<Bands> log2GainPerMetre; // [temp * NUM_HUM + hum]
+    float maxErrorDb = 0.0f;
+
+    // log2 of the per-metre gain for each band at (tempC, humidity).
+    Bands lookup(float tempC, float humidity) const {
+        const float ft = (std::clamp(tempC, TEMP_MIN, TEMP_MAX) - TEMP_MIN) / TEMP_STEP;
+        const float fh = (std::clamp(humidity, HUM_MIN, HUM_MAX) - HUM_MIN) / HUM_STEP;
+        const int t0 = std::min((int)ft, NUM_TEMP - 2);
+        const int h0 = std::min((int)fh, NUM_HUM - 2);
+        const float wt = ft - (float)t0;
+        const float wh = fh - (float)h0;
+        const Bands& a = log2GainPerMetre[t0 * NUM_HUM + h0];
+        const Bands& b = log2GainPerMetre[t0 * NUM_HUM + h0 + 1];
+        const Bands& c = log2GainPerMetre[(t0 + 1) * NUM_HUM + h0];
+        const Bands& d = log2GainPerMetre[(t0 + 1) * NUM_HUM + h0 + 1];
+        Bands out;
+        for (int k = 0; k < NUM_BANDS; ++k) {
+            const float lo = a[k] + wh * (b[k] - a[k]);
+            const float hi = c[k] + wh * (d[k] - c[k]);
+            out[k] = lo + wt * (hi - lo);
+        }
+        return out;
+    }
+
+    static AirAbsorptionTable build() {
+        AirAbsorptionTable table;
+        table.log2GainPerMetre.resize((size_t)NUM_TEMP * NUM_HUM);
+        for (int t = 0; t < NUM_TEMP; ++t) {
+            for (int h = 0; h < NUM_HUM; ++h) {
+                Bands& cell = table.log2GainPerMetre[t * NUM_HUM + h];
+                for (int k = 0; k < NUM_BANDS; ++k)
+                    cell[k] = DB_TO_LOG2 * calcAirAttenuationDb(BAND_FREQS[k], TEMP_MIN + t * TEMP_STEP, HUM_MIN + h * HUM_STEP);
+            }
+        }
+        for (int t = 0; t + 1 < NUM_TEMP; ++t) {
+            for (int h = 0; h + 1 < NUM_HUM; ++h) {
+                const float tempC = TEMP_MIN + (t + 0.5f) * TEMP_STEP;
+                const float humidity = HUM_MIN + (h + 0.5f) * HUM_STEP;
+                const Bands approx = table.lookup(tempC, humidity);
+                for (int k = 0; k < NUM_BANDS; ++k) {
+                    const float err = std::abs(approx[k] / DB_TO_LOG2 - calcAirAttenuationDb(BAND_FREQS[k], tempC, humidity));
+                    table.maxErrorDb = std::max(table.maxErrorDb, err);
+                }
+            }
+        }
+        assert(table.maxErrorDb <= MAX_ERROR_DB && "air absorption grid too coarse for the model");
+        return table;
+    }
+
+    static std::shared_ptr<const AirAbsorptionTable> shared() {
+        return SharedTables::instance<int, AirAbsorptionTable>().get(0, [] { return build(); });
+    }
+};
+
+// Single-producer / single-consumer triple buffer. The writer fills
+// writeBuffer() and publishes it; the reader picks up the newest published
+// slot with update(). Neither side blocks or allocates.
+template <typename T>
+class TripleBuffer {
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int FRESH = 4;
+    std::array<T, 3> slots;
+    std::atomic<int> middle{ 1 };
+    int front = 0;
+    int back = 2;
+public:
+    template <typename Fn>
+    void forEachSlot(Fn&& fn) { for (auto& s : slots) fn(s); }
+
+    T& writeBuffer() { return slots[back]; }
+    void publish() { back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK; }
+
+    bool hasUpdate() const { return (middle.load(std::memory_order_acquire) & FRESH) != 0; }
+    bool update() {
+        if (!hasUpdate()) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    const T& read() const { return slots[front]; }
+};
+
+// Accumulates time per stage of FDNEngine::process. Each recording thread
+// owns a Timeline: start() at the top of a region, lap(stage) after each
+// stage charges the time since the previous mark to it. Totals are
+// single-writer atomics so the audio thread can publish a window that
+// includes the pipeline worker's input stage.
+class StageProfiler {
+public:
+    enum Stage {
+        InputFilter, Dynamics, Velvet, EarlyReflections,
+        DelayRead, MaterialFilter, Allpass, Matrix, Injection,
+        OutputChain, LineGroups, NUM_STAGES
+    };
+    static constexpr bool COUNTS_CYCLES = FDN_HAS_RDTSC != 0;
+    static constexpr double WINDOW_SECONDS = 0.5;
+
+    static const char* stageName(int stage) {
+        static const char* names[NUM_STAGES] = {
+            "Input filters", "Dynamics", "Velvet", "Early reflections",
+            "Delay reads", "Material filters", "Loop allpasses", "Matrix", "Injection + drive",
+            "Output chain", "Line groups (parallel)"
+        };
+        return (stage >= 0 && stage < NUM_STAGES) ? names[stage] : "";
+    }
+
+    static uint64_t now() {
+#if FDN_HAS_RDTSC
+        return (uint64_t)__rdtsc();
+#else
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    class Timeline {
+    public:
+        void start() { last = now(); }
+        void lap(Stage stage) {
+            const uint64_t t = now();
+            totals[stage].store(totals[stage].load(std::memory_order_relaxed) + (t - last), std::memory_order_relaxed);
+            last = t;
+        }
+        uint64_t total(int stage) const { return totals[(size_t)stage].load(std::memory_order_relaxed); }
+    private:
+        uint64_t last = 0;
+        std::array<std::atomic<uint64_t>, NUM_STAGES> totals{};
+    };
+
+    struct Breakdown {
+        bool valid = false;
+        bool cycles = COUNTS_CYCLES;                     // else nanoseconds
+        uint64_t samples = 0;                            // in the window
+        std::array<double, NUM_STAGES> perSample{};      // cycles (or ns) per sample
+        std::array<double, NUM_STAGES> share{};          // fraction of the total
+    };
+
+    Timeline input;      // input stage, on whichever thread runs it
+    Timeline recursion;  // recursion and output stage, audio thread
+
+    // Audio thread, once per process() call.
+    void addSamples(int numSamples, double sampleRate) {
+        windowSamples += (uint64_t)numSamples;
+        if ((double)windowSamples < sampleRate * WINDOW_SECONDS) return;
+        Breakdown& out = snapshots.writeBuffer();
+        double sum = 0.0;
+        for (int s = 0; s < NUM_STAGES; ++s) {
+            const uint64_t total = input.total(s) + recursion.total(s);
+            out.perSample[(size_t)s] = (double)(total - previous[(size_t)s]) / (double)windowSamples;
+            previous[(size_t)s] = total;
+            sum += out.perSample[(size_t)s];
+        }
+        for (int s = 0; s < NUM_STAGES; ++s) out.share[(size_t)s] = sum > 0.0 ? out.perSample[(size_t)s] / sum : 0.0;
+        out.samples = windowSamples;
+        out.valid = true;
+        snapshots.publish();
+        windowSamples = 0;
+    }
+
+    // One reader thread.
+    Breakdown latest() {
+        snapshots.update();
+        return snapshots.read();
+    }
+
+private:
+    TripleBuffer<Breakdown> snapshots;
+    std::array<uint64_t, NUM_STAGES> previous{};
+    uint64_t windowSamples = 0;
+};
+
 // ==============================================================================
 // 2. MATERIAL DATABASE
 // ==============================================================================
@@ -164,13 +713,21 @@ namespace MaterialDB {
 // 3. DSP MODULES
 // ==============================================================================
 
+// Ducking/bloom gain from the dry input level. The envelope follower runs
+// per sample; the gain curve is evaluated every CONTROL_INTERVAL samples in
+// the log2 domain and ramped linearly in between.
 class DynamicsProcessor {
+    static constexpr int CONTROL_INTERVAL = 16;
+    static constexpr float DB_PER_OCTAVE = 6.0205999f; // 20 * log10(2)
     float envelope = 0.0f;
     float attackCoef = 0.0f;
     float releaseCoef = 0.0f;
     float thresholdDB = -20.0f;
     float ratio = 2.0f;
     float sampleRate = 48000.0f;
+    float currentGain = 1.0f;
+    float gainStep = 0.0f;
+    int controlCounter = 0;
 
 public:
     void prepare(float fs) {
@@ -178,48 +735,107 @@ public:
         setParams(-20.0f, 2.0f, 10.0f, 100.0f);
         reset();
     }
-    void reset() { envelope = 0.0f; }
+    void reset() { envelope = 0.0f; currentGain = 1.0f; gainStep = 0.0f; controlCounter = 0; }
     void setParams(float thresh, float r, float attMs, float relMs) {
         thresholdDB = thresh;
         ratio = std::max(1.01f, r);
         attackCoef = std::exp(-1000.0f / (std::max(1.0f, attMs) * sampleRate));
         releaseCoef = std::exp(-1000.0f / (std::max(1.0f, relMs) * sampleRate));
     }
-    inline float process(float input, float amount) {
-        if (std::abs(amount) < 0.01f) return 1.0f;
-        float absIn = std::abs(input);
-        if (absIn > envelope) envelope = attackCoef * envelope + (1.0f - attackCoef) * absIn;
-        else envelope = releaseCoef * envelope + (1.0f - releaseCoef) * absIn;
-        envelope = antiDenormal(envelope);
-        float envDB = 20.0f * std::log10(std::max(1.0e-6f, envelope));
-        float gainChangeDB = 0.0f;
-        if (amount < 0.0f) {
-            if (envDB > thresholdDB) {
-                float over = envDB - thresholdDB;
-                gainChangeDB = -over * (1.0f - 1.0f / ratio);
-            }
+    // Gain for each of n samples, driven by max(|inL|, |inR|).
+    void process(const float* inL, const float* inR, float* gains, int n, float amount) {
+        if (std::abs(amount) < 0.01f) {
+            std::fill(gains, gains + n, 1.0f);
+            currentGain = 1.0f;
+            gainStep = 0.0f;
+            controlCounter = 0;
+            return;
         }
-        else {
-            if (envDB > thresholdDB) {
-                float over = envDB - thresholdDB;
-                gainChangeDB = over * (1.0f - 1.0f / ratio);
+        for (int k = 0; k < n; ++k) {
+            float absIn = std::max(std::abs(inL[k]), std::abs(inR[k]));
+            if (absIn > envelope) envelope = attackCoef * envelope + (1.0f - attackCoef) * absIn;
+            else envelope = releaseCoef * envelope + (1.0f - releaseCoef) * absIn;
+            envelope = antiDenormal(envelope);
+            if (controlCounter == 0) {
+                gainStep = (computeGain(amount) - currentGain) * (1.0f / (float)CONTROL_INTERVAL);
+                controlCounter = CONTROL_INTERVAL;
             }
+            currentGain += gainStep;
+            controlCounter--;
+            gains[k] = currentGain;
+        }
+    }
+private:
+    float computeGain(float amount) const {
+        float envDB = DB_PER_OCTAVE * fastLog2(std::max(1.0e-6f, envelope));
+        float gainChangeDB = 0.0f;
+        if (envDB > thresholdDB) {
+            float over = envDB - thresholdDB;
+            gainChangeDB = over * (1.0f - 1.0f / ratio);
+            if (amount < 0.0f) gainChangeDB = -gainChangeDB;
         }
         gainChangeDB *= std::abs(amount);
-        if (gainChangeDB > 24.0f) gainChangeDB = 24.0f;
-        if (gainChangeDB < -60.0f) gainChangeDB = -60.0f;
-        return std::pow(10.0f, gainChangeDB / 20.0f);
+        gainChangeDB = std::clamp(gainChangeDB, -60.0f, 24.0f);
+        return fastPow2(gainChangeDB * (1.0f / DB_PER_OCTAVE));
     }
 };
 
-class TiltEqualizer {
+// --- Stereo-packed biquad ---
+// L and R share coefficients; their state sits in the low two lanes of one
+// register, so a stereo pair costs the same instructions as one mono filter.
+// Works in place on interleaved L/R frames.
+struct StereoBiquad {
     float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
-    float x1 = 0.0f, x2 = 0.0f, y1 = 0.0f, y2 = 0.0f;
+    float x1[2] = {}, x2[2] = {}, y1[2] = {}, y2[2] = {};
+
+    void reset() {
+        for (int c = 0; c < 2; ++c) x1[c] = x2[c] = y1[c] = y2[c] = 0.0f;
+    }
+    void setCoeffs(float nb0, float nb1, float nb2, float na1, float na2) {
+        b0 = nb0; b1 = nb1; b2 = nb2; a1 = na1; a2 = na2;
+    }
+    void process(float* lr, int n) {
+#if FDN_HAS_SSE2
+        const __m128 B0 = _mm_set1_ps(b0), B1 = _mm_set1_ps(b1), B2 = _mm_set1_ps(b2);
+        const __m128 A1 = _mm_set1_ps(a1), A2 = _mm_set1_ps(a2);
+        __m128 X1 = _mm_setr_ps(x1[0], x1[1], 0.0f, 0.0f), X2 = _mm_setr_ps(x2[0], x2[1], 0.0f, 0.0f);
+        __m128 Y1 = _mm_setr_ps(y1[0], y1[1], 0.0f, 0.0f), Y2 = _mm_setr_ps(y2[0], y2[1], 0.0f, 0.0f);
+        for (int k = 0; k < n; ++k) {
+            __m128i* frame = reinterpret_cast<__m128i*>(lr + 2 * k);
+            const __m128 in = _mm_castsi128_ps(_mm_loadl_epi64(frame));
+            __m128 out = _mm_add_ps(_mm_mul_ps(B0, in), _mm_mul_ps(B1, X1));
+            out = _mm_add_ps(out, _mm_mul_ps(B2, X2));
+            out = _mm_sub_ps(out, _mm_mul_ps(A1, Y1));
+            out = _mm_sub_ps(out, _mm_mul_ps(A2, Y2));
+            X2 = X1; X1 = in; Y2 = Y1; Y1 = out;
+            _mm_storel_epi64(frame, _mm_castps_si128(out));
+        }
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, X1); x1[0] = lanes[0]; x1[1] = lanes[1];
+        _mm_store_ps(lanes, X2); x2[0] = lanes[0]; x2[1] = lanes[1];
+        _mm_store_ps(lanes, Y1); y1[0] = lanes[0]; y1[1] = lanes[1];
+        _mm_store_ps(lanes, Y2); y2[0] = lanes[0]; y2[1] = lanes[1];
+#else
+        for (int k = 0; k < n; ++k) {
+            for (int c = 0; c < 2; ++c) {
+                const float in = lr[2 * k + c];
+                float out = b0 * in + b1 * x1[c] + b2 * x2[c] - a1 * y1[c] - a2 * y2[c];
+                out = antiDenormal(out);
+                x2[c] = x1[c]; x1[c] = in; y2[c] = y1[c]; y1[c] = out;
+                lr[2 * k + c] = out;
+            }
+        }
+#endif
+    }
+};
+
+class TiltEqualizer {
+    StereoBiquad section;
     float sampleRate = 48000.0f;
     float currentGainDB = 0.0f;
 public:
     void prepare(float fs) { sampleRate = fs; reset(); }
-    void reset() { x1 = x2 = y1 = y2 = 0.0f; b0 = 1.0f; b1 = b2 = a1 = a2 = 0.0f; currentGainDB = 0.0f; }
+    void reset() { section.reset(); section.setCoeffs(1.0f, 0.0f, 0.0f, 0.0f, 0.0f); currentGainDB = 0.0f; }
     void setTilt(float gainDB) {
         if (std::abs(gainDB - currentGainDB) < 0.01f) return;
         currentGainDB = gainDB;
@@ -232,18 +848,15 @@ public:
         float alpha = sinW / 2.0f * std::sqrt((A + 1.0f / A) * (1.0f / 0.707f - 1.0f) + 2.0f);
         float a0_inv = 1.0f / ((A + 1.0f) - (A - 1.0f) * cosW + 2.0f * std::sqrt(A) * alpha);
         float pivotGain = 1.0f / A;
-        b0 = A * ((A + 1.0f) + (A - 1.0f) * cosW + 2.0f * std::sqrt(A) * alpha) * a0_inv * pivotGain;
-        b1 = -2.0f * A * ((A - 1.0f) + (A + 1.0f) * cosW) * a0_inv * pivotGain;
-        b2 = A * ((A + 1.0f) + (A - 1.0f) * cosW - 2.0f * std::sqrt(A) * alpha) * a0_inv * pivotGain;
-        a1 = 2.0f * ((A - 1.0f) - (A + 1.0f) * cosW) * a0_inv;
-        a2 = ((A + 1.0f) - (A - 1.0f) * cosW - 2.0f * std::sqrt(A) * alpha) * a0_inv;
-    }
-    inline float process(float in) {
-        float out = b0 * in + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
-        out = antiDenormal(out);
-        x2 = x1; x1 = in; y2 = y1; y1 = out;
-        return out;
+        section.setCoeffs(
+            A * ((A + 1.0f) + (A - 1.0f) * cosW + 2.0f * std::sqrt(A) * alpha) * a0_inv * pivotGain,
+            -2.0f * A * ((A - 1.0f) + (A + 1.0f) * cosW) * a0_inv * pivotGain,
+            A * ((A + 1.0f) + (A - 1.0f) * cosW - 2.0f * std::sqrt(A) * alpha) * a0_inv * pivotGain,
+            2.0f * ((A - 1.0f) - (A + 1.0f) * cosW) * a0_inv,
+            ((A + 1.0f) - (A - 1.0f) * cosW - 2.0f * std::sqrt(A) * alpha) * a0_inv);
     }
+    // Interleaved L/R, in place.
+    void process(float* lr, int n) { section.process(lr, n); }
 };
 
 class DCBlocker {
@@ -259,6 +872,40 @@ public:
     }
 };
 
+// DCBlocker for an interleaved L/R block, both channels in one register.
+class StereoDCBlocker {
+    float x1[2] = {}, y1[2] = {};
+    static constexpr float R = 0.9975f;
+public:
+    void reset() { x1[0] = x1[1] = y1[0] = y1[1] = 0.0f; }
+    void process(float* lr, int n) {
+#if FDN_HAS_SSE2
+        const __m128 coef = _mm_set1_ps(R);
+        __m128 X1 = _mm_setr_ps(x1[0], x1[1], 0.0f, 0.0f);
+        __m128 Y1 = _mm_setr_ps(y1[0], y1[1], 0.0f, 0.0f);
+        for (int k = 0; k < n; ++k) {
+            __m128i* frame = reinterpret_cast<__m128i*>(lr + 2 * k);
+            const __m128 x = _mm_castsi128_ps(_mm_loadl_epi64(frame));
+            Y1 = _mm_add_ps(_mm_sub_ps(x, X1), _mm_mul_ps(coef, Y1));
+            X1 = x;
+            _mm_storel_epi64(frame, _mm_castps_si128(Y1));
+        }
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, X1); x1[0] = lanes[0]; x1[1] = lanes[1];
+        _mm_store_ps(lanes, Y1); y1[0] = lanes[0]; y1[1] = lanes[1];
+#else
+        for (int k = 0; k < n; ++k) {
+            for (int c = 0; c < 2; ++c) {
+                const float x = lr[2 * k + c];
+                const float y = antiDenormal(x - x1[c] + R * y1[c]);
+                x1[c] = x; y1[c] = y;
+                lr[2 * k + c] = y;
+            }
+        }
+#endif
+    }
+};
+
 class ParameterSmoother {
     float currentValue = 0.0f, targetValue = 0.0f, step = 0.0f;
     int countdown = 0;
@@ -275,29 +922,87 @@ public:
     }
     void snapTo(float value) { currentValue = targetValue = value; countdown = 0; step = 0.0f; }
     float getCurrent() const { return currentValue; }
+    float getTarget() const { return targetValue; }
 };
 
-class ChaosLFO {
-    float phase1 = 0.0f, phase2 = 0.0f, inc1 = 0.0f, inc2 = 0.0f;
+#if FDN_HAS_SSE2
+// sin(2*pi*p) for p in [0, 1). Folds to |x| <= pi/2 and uses the degree-11
+// Taylor polynomial there; error is below 1e-7.
+static inline __m128 sin2PiPS(__m128 p) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 x = _mm_sub_ps(p, _mm_set1_ps(0.5f)); // sin(2*pi*p) = -sin(2*pi*x)
+    const __m128 sign = _mm_and_ps(x, signMask);
+    __m128 ax = _mm_andnot_ps(signMask, x);
+    ax = _mm_min_ps(ax, _mm_sub_ps(_mm_set1_ps(0.5f), ax));
+    const __m128 t = _mm_mul_ps(ax, _mm_set1_ps(PI_2));
+    const __m128 t2 = _mm_mul_ps(t, t);
+    __m128 poly = _mm_set1_ps(-2.5052108e-8f);
+    poly = _mm_add_ps(_mm_mul_ps(poly, t2), _mm_set1_ps(2.7557319e-6f));
+    poly = _mm_add_ps(_mm_mul_ps(poly, t2), _mm_set1_ps(-1.9841270e-4f));
+    poly = _mm_add_ps(_mm_mul_ps(poly, t2), _mm_set1_ps(8.3333333e-3f));
+    poly = _mm_add_ps(_mm_mul_ps(poly, t2), _mm_set1_ps(-1.6666667e-1f));
+    poly = _mm_add_ps(_mm_mul_ps(poly, t2), _mm_set1_ps(1.0f));
+    return _mm_xor_ps(_mm_mul_ps(t, poly), _mm_xor_ps(sign, signMask));
+}
+#endif
+
+// The per-line dual-sine LFOs, stored as arrays so four of them advance in
+// one pass. A line with zero frequency holds its phase and outputs 0. Each
+// group of four lines owns one cache line, so line-group workers advancing
+// neighbouring groups do not share one.
+class ChaosLFOBank {
+    struct alignas(64) Quad {
+        float phase1[4] = {};
+        float phase2[4] = {};
+        float inc1[4] = {};
+        float inc2[4] = {};
+    };
+    Quad quads[FDN_CHANNELS / 4];
 public:
-    void setFrequency(float freq, float sampleRate) {
+    void setFrequency(int line, float freq, float sampleRate) {
         float safeFreq = (freq > 0.0f) ? freq : 0.0f;
-        inc1 = safeFreq / sampleRate;
-        inc2 = (safeFreq * 1.41421356f) / sampleRate;
+        Quad& q = quads[line / 4];
+        q.inc1[line % 4] = safeFreq / sampleRate;
+        q.inc2[line % 4] = (safeFreq * 1.41421356f) / sampleRate;
     }
-    void setPhase(float p) { phase1 = p; phase2 = p * 1.618f; }
-    inline float process() {
-        if (inc1 <= 0.0f) return 0.0f;
-        phase1 += inc1; if (phase1 >= 1.0f) phase1 -= 1.0f;
-        phase2 += inc2; if (phase2 >= 1.0f) phase2 -= 1.0f;
-        return (std::sin(phase1 * PI_2) + std::sin(phase2 * PI_2)) * 0.5f;
+    void setPhase(int line, float p) {
+        Quad& q = quads[line / 4];
+        q.phase1[line % 4] = p;
+        q.phase2[line % 4] = p * 1.618f;
+    }
+    void process(float* out) {
+        for (int i = 0; i < FDN_CHANNELS; i += 4) processGroup(i, out + i);
+    }
+    // Advances lines first..first+3 and writes their values to out[0..3].
+    void processGroup(int first, float* out) {
+        Quad& q = quads[first / 4];
+#if FDN_HAS_SSE2
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 i1 = _mm_load_ps(q.inc1);
+        const __m128 running = _mm_cmpgt_ps(i1, _mm_setzero_ps());
+        __m128 p1 = _mm_add_ps(_mm_load_ps(q.phase1), _mm_and_ps(i1, running));
+        __m128 p2 = _mm_add_ps(_mm_load_ps(q.phase2), _mm_and_ps(_mm_load_ps(q.inc2), running));
+        p1 = _mm_sub_ps(p1, _mm_and_ps(_mm_cmpge_ps(p1, one), one));
+        p2 = _mm_sub_ps(p2, _mm_and_ps(_mm_cmpge_ps(p2, one), one));
+        _mm_store_ps(q.phase1, p1);
+        _mm_store_ps(q.phase2, p2);
+        const __m128 v = _mm_mul_ps(_mm_add_ps(sin2PiPS(p1), sin2PiPS(p2)), half);
+        _mm_storeu_ps(out, _mm_and_ps(v, running));
+#else
+        for (int i = 0; i < 4; ++i) {
+            if (q.inc1[i] <= 0.0f) { out[i] = 0.0f; continue; }
+            q.phase1[i] += q.inc1[i]; if (q.phase1[i] >= 1.0f) q.phase1[i] -= 1.0f;
+            q.phase2[i] += q.inc2[i]; if (q.phase2[i] >= 1.0f) q.phase2[i] -= 1.0f;
+            out[i] = (std::sin(q.phase1[i] * PI_2) + std::sin(q.phase2[i] * PI_2)) * 0.5f;
+        }
+#endif
     }
 };
 
 class LagrangeInterpolator {
 public:
-    static inline float process(const std::vector<float>& buffer, float readPos) {
-        int size = (int)buffer.size();
+    static inline float process(const float* buffer, int size, float readPos) {
         if (size == 0) return 0.0f;
         while (readPos < 0.0f) readPos += (float)size;
         while (readPos >= (float)size) readPos -= (float)size;
@@ -307,6 +1012,23 @@ public:
         int i1 = (i0 + 1) % size;
         int i2 = (i0 + 2) % size;
         float ym1 = buffer[im1], y0 = buffer[i0], y1 = buffer[i1], y2 = buffer[i2];
+        return interpolate(ym1, y0, y1, y2, frac);
+    }
+    // Slow path for reads that reach past the samples written since reset.
+    static inline float processEpoch(const float* buffer, int size, float readPos, int writePos, int valid) {
+        if (size == 0) return 0.0f;
+        while (readPos < 0.0f) readPos += (float)size;
+        while (readPos >= (float)size) readPos -= (float)size;
+        int i0 = (int)readPos;
+        float frac = readPos - (float)i0;
+        int im1 = (i0 - 1 + size) % size;
+        int i1 = (i0 + 1) % size;
+        int i2 = (i0 + 2) % size;
+        return interpolate(epochRead(buffer, size, im1, writePos, valid), epochRead(buffer, size, i0, writePos, valid),
+            epochRead(buffer, size, i1, writePos, valid), epochRead(buffer, size, i2, writePos, valid), frac);
+    }
+private:
+    static inline float interpolate(float ym1, float y0, float y1, float y2, float frac) {
         float c0 = y0;
         float c1 = y1 - ym1 * (1.0f / 3.0f) - y0 * 0.5f - y2 * (1.0f / 6.0f);
         float c2 = (ym1 + y1) * 0.5f - y0;
@@ -318,6 +1040,7 @@ public:
 class LoopAllpass {
     std::vector<float> buffer;
     int writePos = 0;
+    int validSamples = 0;
     int currentDelayLen = 0;
     float gain = 0.0f;
     float lfoPhase = 0.0f;
@@ -326,6 +1049,7 @@ class LoopAllpass {
 public:
     void setup(int maxLen, float sampleRate) {
         buffer.resize(maxLen + 128, 0.0f);
+        validSamples = 0;
         currentDelayLen = findNearestPrime(std::max(1, maxLen / 2));
     }
     void setBaseDelay(int samples) {
@@ -338,7 +1062,7 @@ public:
         lfoDepth = depth * std::min(12.0f, (float)currentDelayLen * 0.15f);
         lfoPhase = (float)channelIdx * 0.618f * PI_2;
     }
-    void reset() { std::fill(buffer.begin(), buffer.end(), 0.0f); writePos = 0; lfoPhase = 0.0f; }
+    void reset() { writePos = 0; validSamples = 0; lfoPhase = 0.0f; }
     inline float process(float in) {
         float mod = 0.0f;
         if (lfoDepth > 0.0f) {
@@ -352,13 +1076,19 @@ public:
         while (readPos >= (float)bufSize) readPos -= (float)bufSize;
         int idxA = (int)readPos;
         float frac = readPos - (float)idxA;
-        float delayed = buffer[idxA] * (1.0f - frac) + buffer[(idxA + 1) % bufSize] * frac;
+        int idxB = (idxA + 1) % bufSize;
+        float delayed;
+        if (validSamples < bufSize && (float)currentDelayLen - mod + 1.0f > (float)validSamples)
+            delayed = epochRead(buffer, bufSize, idxA, writePos, validSamples) * (1.0f - frac) + epochRead(buffer, bufSize, idxB, writePos, validSamples) * frac;
+        else
+            delayed = buffer[idxA] * (1.0f - frac) + buffer[idxB] * frac;
         float v_n = in + gain * delayed;
         v_n = safeLoopSaturate(v_n);
         v_n = antiDenormal(v_n);
         buffer[writePos] = v_n;
         float out = delayed - gain * v_n;
         writePos = (writePos + 1) % bufSize;
+        if (validSamples < bufSize) validSamples++;
         return out;
     }
 };
@@ -381,20 +1111,10 @@ public:
     }
 };
 
+// 4th-order HP + 4th-order LP on an interleaved stereo block.
 class HighQualityFilter {
-    struct BiquadSection {
-        float b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
-        float x1 = 0, x2 = 0, y1 = 0, y2 = 0;
-        void reset() { x1 = x2 = y1 = y2 = 0.0f; }
-        inline float process(float in) {
-            float out = b0 * in + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
-            out = antiDenormal(out);
-            x2 = x1; x1 = in; y2 = y1; y1 = out;
-            return y1;
-        }
-    };
-    BiquadSection lpSection1, lpSection2;
-    BiquadSection hpSection1, hpSection2;
+    StereoBiquad lpSection1, lpSection2;
+    StereoBiquad hpSection1, hpSection2;
     float currentLPFreq = 20000.0f;
     float currentHPFreq = 20.0f;
     float sampleRate = 48000.0f;
@@ -413,11 +1133,15 @@ public:
         calculateHPCoeffs(hpSection1, freq, 0.707f);
         calculateHPCoeffs(hpSection2, freq, 0.707f);
     }
-    inline float process(float in) {
-        return lpSection2.process(lpSection1.process(hpSection2.process(hpSection1.process(in))));
+    // Interleaved L/R, in place.
+    void process(float* lr, int n) {
+        hpSection1.process(lr, n);
+        hpSection2.process(lr, n);
+        lpSection1.process(lr, n);
+        lpSection2.process(lr, n);
     }
 private:
-    void calculateLPCoeffs(BiquadSection& s, float freq, float Q) {
+    void calculateLPCoeffs(StereoBiquad& s, float freq, float Q) {
         float w0 = 2.0f * PI * freq / sampleRate;
         float alpha = std::sin(w0) / (2.0f * Q);
         float cosw0 = std::cos(w0);
@@ -429,7 +1153,7 @@ private:
         s.a1 = (-2.0f * cosw0) * invA0;
         s.a2 = (1.0f - alpha) * invA0;
     }
-    void calculateHPCoeffs(BiquadSection& s, float freq, float Q) {
+    void calculateHPCoeffs(StereoBiquad& s, float freq, float Q) {
         float w0 = 2.0f * PI * freq / sampleRate;
         float alpha = std::sin(w0) / (2.0f * Q);
         float cosw0 = std::cos(w0);
@@ -540,32 +1264,35 @@ public:
     }
 };
 
+// Velvet-noise tap tables: sparse taps of random sign on a jittered grid.
+// Rendered by VelvetBlockDiffuser and, for the long variants, VelvetTailSpectra.
 struct VelvetNoiseDiffuser {
-    std::vector<float> buffer;
-    int writePos = 0;
-    int bufferMask = 0;
     struct Tap { int delay; float gain; };
-    std::vector<Tap> taps;
-    float amount = 0.0f;
 
-    void prepare(float fs) {
-        float durationMs = 50.0f;
-        int minSamples = (int)(durationMs * fs * 0.001f) + 1024;
+    static constexpr float durationMs = 50.0f;
+    static constexpr int numTaps = 48;
+    static constexpr float tapsPerMs = 0.96f; // 48 taps over 50 ms
+
+    static int bufferSizeFor(float fs, float lengthMs = durationMs) {
+        int minSamples = (int)(lengthMs * fs * 0.001f) + 1024;
         int size = 1;
         while (size < minSamples) size *= 2;
-        if ((int)buffer.size() != size) buffer.assign(size, 0.0f);
-        else std::fill(buffer.begin(), buffer.end(), 0.0f);
-        bufferMask = size - 1;
-        writePos = 0;
-        taps.clear();
-        int numTaps = 48;
-        float totalSamples = durationMs * fs * 0.001f;
-        float grid = totalSamples / (float)numTaps;
+        return size;
+    }
+    static int tapCountFor(float lengthMs) {
+        return std::max(numTaps, (int)std::lround(lengthMs * tapsPerMs));
+    }
+    static std::vector<Tap> buildTaps(float fs, float lengthMs = durationMs) {
+        std::vector<Tap> result;
+        int count = tapCountFor(lengthMs);
+        int size = bufferSizeFor(fs, lengthMs);
+        float totalSamples = lengthMs * fs * 0.001f;
+        float grid = totalSamples / (float)count;
         std::mt19937 gen(12345);
         std::uniform_real_distribution<float> distOffset(0.0f, grid - 1.0f);
         std::uniform_int_distribution<> sign(0, 1);
-        float normGain = 1.0f / std::sqrt((float)numTaps);
-        for (int i = 0; i < numTaps; ++i) {
+        float normGain = 1.0f / std::sqrt((float)count);
+        for (int i = 0; i < count; ++i) {
             Tap t;
             float gridStart = (float)i * grid;
             float offset = distOffset(gen);
@@ -573,180 +1300,941 @@ struct VelvetNoiseDiffuser {
             if (t.delay < 1) t.delay = 1;
             if (t.delay >= size) t.delay = size - 1;
             t.gain = (sign(gen) == 0 ? 1.0f : -1.0f) * normGain;
-            taps.push_back(t);
+            result.push_back(t);
         }
+        return result;
     }
-    void setAmount(float a) { amount = a; }
-    void reset() { std::fill(buffer.begin(), buffer.end(), 0.0f); writePos = 0; }
-    inline float process(float in) {
-        if (amount < 0.01f) return in;
-        if (buffer.empty()) return in;
-        buffer[writePos] = in;
-        float out = 0.0f;
-        for (const auto& t : taps) {
-            int r = (writePos - t.delay) & bufferMask;
-            out += buffer[r] * t.gain;
-        }
-        writePos = (writePos + 1) & bufferMask;
-        return in * (1.0f - amount) + out * amount;
+    static std::shared_ptr<const std::vector<Tap>> sharedTaps(float fs, float lengthMs = durationMs) {
+        std::pair<int, int> key((int)std::lround(fs), (int)std::lround(lengthMs));
+        return SharedTables::instance<std::pair<int, int>, std::vector<Tap>>().get(key, [fs, lengthMs] { return buildTaps(fs, lengthMs); });
     }
 };
 
-struct EarlyReflections {
-    std::vector<float> predelayBuffer;
-    int preWritePos = 0;
-    float fs = 48000.0f;
-    struct Reflection {
-        int delaySamples = 0;
-        float gain = 0.0f;
-        float panL = 0.5f;
-        float panR = 0.5f;
-    };
-    std::array<Reflection, 7> taps;
-    EarlyReflections() {}
-    void prepare(double sampleRate) {
-        fs = (float)sampleRate;
-        int size = (int)(static_cast<double>(MAX_DELAY_SECONDS) * sampleRate) + 4096;
-        if (predelayBuffer.size() < size) predelayBuffer.resize(size, 0.0f);
+// Renders a VelvetNoiseDiffuser tap table. Every tap adds or subtracts a shifted span
+// of the input, so the inner loop is a contiguous multiply-add over 2 * n
+// interleaved L/R samples. History lives in a linear buffer that is slid back
+// only when the write position reaches the end.
+struct VelvetBlockDiffuser {
+    using Tap = VelvetNoiseDiffuser::Tap;
+    std::vector<float> lanes;      // interleaved L/R frames: [history | blocks]
+    int historyLen = 0;            // frames kept behind the write position
+    int capacity = 0;              // frames in 'lanes'
+    int pos = 0;                   // frame index of the next block
+    int validSamples = 0;          // frames written since reset
+
+    void prepare(int maxDelay) {
+        historyLen = std::max(1, maxDelay);
+        // A slide copies historyLen frames; slack of the same size keeps that
+        // at about one frame copied per frame written, whatever the length.
+        capacity = historyLen + std::max(historyLen, PROCESS_BLOCK);
+        lanes.assign((size_t)capacity * 2, 0.0f);
         reset();
     }
-    void reset() { std::fill(predelayBuffer.begin(), predelayBuffer.end(), 0.0f); preWritePos = 0; }
-    void updateGeometry(float W, float D, float H, float predelayMs, float srcH, float diffusion, float dist, float pan) {
-        float c = SPEED_OF_SOUND;
-        int baseDelay = (int)(predelayMs * 0.001f * fs);
-        float sx = pan * (W * 0.45f);
-        float sy = (srcH - 0.5f) * H;
-        float sz = (dist - 0.5f) * D;
-        float lx = 0.0f;
-        float ly = 0.0f;
-        float lz = -D * 0.45f;
-        float dDirect = std::sqrt(std::pow(sx - lx, 2) + std::pow(sy - ly, 2) + std::pow(sz - lz, 2));
-        float dFloor = std::sqrt(std::pow(sx - lx, 2) + std::pow(-H - sy - ly, 2) + std::pow(sz - lz, 2));
-        float dCeil = std::sqrt(std::pow(sx - lx, 2) + std::pow(H + (H / 2.0f - sy) - ly, 2) + std::pow(sz - lz, 2));
-        float dLeft = std::sqrt(std::pow(-W - sx - lx, 2) + std::pow(sy - ly, 2) + std::pow(sz - lz, 2));
-        float dRight = std::sqrt(std::pow(W + (W / 2.0f - sx) - lx, 2) + std::pow(sy - ly, 2) + std::pow(sz - lz, 2));
-        float dFront = std::sqrt(std::pow(sx - lx, 2) + std::pow(sy - ly, 2) + std::pow(D + (D / 2.0f - sz) - lz, 2));
-        float dBack = std::sqrt(std::pow(sx - lx, 2) + std::pow(sy - ly, 2) + std::pow(-D - sz - lz, 2));
-        float paths[7] = { dFloor, dCeil, dLeft, dRight, dFront, dBack, (dFloor + dCeil + dLeft + dRight) * 0.25f + 1.0f };
-        int maxBuf = (int)predelayBuffer.size();
-        for (int i = 0; i < 7; ++i) {
-            float pathDiff = paths[i] - dDirect;
-            if (pathDiff < 0.1f) pathDiff = 0.1f;
-            float timeSec = pathDiff / c;
-            int samp = baseDelay + (int)(timeSec * fs);
-            taps[i].delaySamples = std::clamp(samp, 1, maxBuf - 1);
-            float distAtten = 1.0f / (1.0f + paths[i] * 0.5f);
-            taps[i].gain = distAtten * (1.0f - diffusion * 0.3f);
-            if (i == 2) { taps[i].panL = 0.9f; taps[i].panR = 0.1f; }
-            else if (i == 3) { taps[i].panL = 0.1f; taps[i].panR = 0.9f; }
-            else { taps[i].panL = 0.5f; taps[i].panR = 0.5f; }
-        }
-    }
-    inline void process(float input, float& outL, float& outR) {
-        int size = (int)predelayBuffer.size();
-        predelayBuffer[preWritePos] = input;
-        float sumL = 0.0f;
-        float sumR = 0.0f;
-        for (const auto& tap : taps) {
-            int idx = preWritePos - tap.delaySamples;
-            if (idx < 0) idx += size;
-            float val = predelayBuffer[idx] * tap.gain;
-            sumL += val * tap.panL;
-            sumR += val * tap.panR;
-        }
-        outL = sumL;
-        outR = sumR;
-        preWritePos++;
-        if (preWritePos >= size) preWritePos = 0;
+    void reset() { pos = historyLen; validSamples = 0; }
+
+    // Appends n frames (n <= PROCESS_BLOCK) and returns them interleaved.
+    float* write(const float* inL, const float* inR, int n) {
+        if (pos + n > capacity) {
+            std::copy(lanes.begin() + 2 * (pos - historyLen), lanes.begin() + 2 * pos, lanes.begin());
+            pos = historyLen;
+        }
+        float* x = lanes.data() + 2 * pos;
+        for (int k = 0; k < n; ++k) { x[2 * k] = inL[k]; x[2 * k + 1] = inR[k]; }
+        return x;
+    }
+    // Sums taps[0..count) over the block written last into acc (2 * n floats).
+    void accumulate(const Tap* taps, int count, const float* x, float* acc, int n) const {
+        const int lanesN = 2 * n;
+        for (int i = 0; i < count; ++i) {
+            const Tap& t = taps[i];
+            // Frames older than the last reset read as silence.
+            int start = 2 * std::max(0, t.delay - validSamples);
+            const float* src = x - 2 * t.delay;
+            const float g = t.gain;
+            for (int k = start; k < lanesN; ++k) acc[k] += src[k] * g;
+        }
+    }
+    void advance(int n) {
+        pos += n;
+        validSamples = std::min(validSamples + n, historyLen);
     }
 };
 
-struct alignas(64) FDNChannel {
-    std::vector<float> buffer;
-    int writePos = 0;
-    ChaosLFO lfo;
-    MaterialFilter4Band materialFilter;
-    LoopAllpass loopAllpass1;
-    LoopAllpass loopAllpass2;
-    DCBlocker feedbackDCBlocker;
-    ParameterSmoother delaySmoother;
-    ParameterSmoother gainSmoother;
-    ParameterSmoother densitySmoother;
-    FDNChannel() {}
-    void prepare(double sampleRate) {
-        int size = (int)(MAX_DELAY_SECONDS * sampleRate) + 4096;
-        if (buffer.size() < size) {
-            buffer.resize(size, 0.0f);
+// --- Radix-2 complex FFT ---
+class ComplexFFT {
+    int size = 0;
+    std::vector<std::complex<float>> twiddles;
+    std::vector<int> bitReverse;
+public:
+    void prepare(int n) {
+        size = n;
+        twiddles.resize(n / 2);
+        for (int k = 0; k < n / 2; ++k) {
+            double phase = -2.0 * 3.14159265358979323846 * (double)k / (double)n;
+            twiddles[k] = { (float)std::cos(phase), (float)std::sin(phase) };
+        }
+        bitReverse.resize(n);
+        int bits = 0;
+        while ((1 << bits) < n) bits++;
+        for (int i = 0; i < n; ++i) {
+            int r = 0;
+            for (int b = 0; b < bits; ++b) if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+            bitReverse[i] = r;
         }
-        loopAllpass1.setup(4096, (float)sampleRate);
-        loopAllpass2.setup(4096, (float)sampleRate);
-    }
-    inline void push(float sample) {
-        sample = feedbackDCBlocker.process(sample);
-        sample = antiDenormal(sample);
-        buffer[writePos] = sample;
-        writePos++;
-        if (writePos >= (int)buffer.size()) writePos = 0;
-    }
-    inline float read(float modDepth) {
-        float lfoVal = 0.0f;
-        if (modDepth > 0.001f) lfoVal = lfo.process();
-        float currentDelay = delaySmoother.getNext();
-        float modulatedDelay = currentDelay + (lfoVal * modDepth);
-        if (modulatedDelay < 2.0f) modulatedDelay = 2.0f;
-        float r = (float)writePos - modulatedDelay;
-        int size = (int)buffer.size();
-        if (r < 0.0f) r += (float)size;
-        else if (r >= (float)size) r -= (float)size;
-        return LagrangeInterpolator::process(buffer, r);
     }
-    inline float getSmoothedGain() { return gainSmoother.getNext(); }
-    void setDensity(float amount, int samplesToSmooth) {
-        float g = amount * 0.6f;
-        densitySmoother.setTarget(g, samplesToSmooth);
+    int getSize() const { return size; }
+    void forward(std::complex<float>* data) const { transform(data, false); }
+    void inverse(std::complex<float>* data) const {
+        transform(data, true);
+        const float scale = 1.0f / (float)size;
+        for (int i = 0; i < size; ++i) data[i] *= scale;
     }
-    inline float processFilter(float sample) {
-        float g = densitySmoother.getNext();
-        loopAllpass1.setGain(g);
-        loopAllpass2.setGain(g);
-        float out = materialFilter.process(sample);
-        out = loopAllpass1.process(out);
-        out = loopAllpass2.process(out);
-        return out;
+private:
+    void transform(std::complex<float>* data, bool inv) const {
+        for (int i = 0; i < size; ++i) if (i < bitReverse[i]) std::swap(data[i], data[bitReverse[i]]);
+        for (int len = 2; len <= size; len <<= 1) {
+            const int half = len / 2;
+            const int step = size / len;
+            for (int i = 0; i < size; i += len) {
+                for (int j = 0; j < half; ++j) {
+                    const std::complex<float> w = twiddles[j * step];
+                    const float wr = w.real(), wi = inv ? -w.imag() : w.imag();
+                    const std::complex<float> u = data[i + j];
+                    const std::complex<float> v = data[i + j + half];
+                    const float vr = v.real() * wr - v.imag() * wi;
+                    const float vi = v.real() * wi + v.imag() * wr;
+                    data[i + j] = { u.real() + vr, u.imag() + vi };
+                    data[i + j + half] = { u.real() - vr, u.imag() - vi };
+                }
+            }
+        }
     }
-    void reset() {
-        std::fill(buffer.begin(), buffer.end(), 0.0f);
-        writePos = 0;
-        materialFilter.reset();
-        loopAllpass1.reset();
-        loopAllpass2.reset();
-        feedbackDCBlocker.reset();
-        delaySmoother.snapTo(1000.0f);
-        gainSmoother.snapTo(0.0f);
-        densitySmoother.snapTo(0.0f);
+};
+
+// Partition spectra of the part of a velvet sequence at or beyond one
+// partition (the head is rendered in the time domain). Immutable, shared.
+struct VelvetTailSpectra {
+    int partitionSize = 0;
+    int numPartitions = 0;                      // partitions 1..numPartitions
+    std::vector<std::complex<float>> bins;      // numPartitions * 2 * partitionSize
+
+    static VelvetTailSpectra build(const std::vector<VelvetNoiseDiffuser::Tap>& taps, int partitionSize) {
+        VelvetTailSpectra s;
+        s.partitionSize = partitionSize;
+        const int n = 2 * partitionSize;
+        int maxDelay = 0;
+        for (const auto& t : taps) maxDelay = std::max(maxDelay, t.delay);
+        s.numPartitions = std::max(0, maxDelay / partitionSize);
+        s.bins.assign((size_t)s.numPartitions * n, { 0.0f, 0.0f });
+        ComplexFFT fft;
+        fft.prepare(n);
+        for (const auto& t : taps) {
+            int p = t.delay / partitionSize;
+            if (p < 1) continue;
+            s.bins[(size_t)(p - 1) * n + (t.delay - p * partitionSize)] += t.gain;
+        }
+        for (int p = 0; p < s.numPartitions; ++p) fft.forward(s.bins.data() + (size_t)p * n);
+        return s;
     }
 };
 
-// --- MATRIX FUNCTIONS ---
-static inline void matrixHadamard(float* x) {
-    for (int i = 0; i < 16; i += 2) { float a = x[i]; float b = x[i + 1]; x[i] = a + b; x[i + 1] = a - b; }
-    for (int i = 0; i < 16; i += 4) {
-        float a0 = x[i]; float b0 = x[i + 2]; x[i] = a0 + b0; x[i + 2] = a0 - b0;
-        float a1 = x[i + 1]; float b1 = x[i + 3]; x[i + 1] = a1 + b1; x[i + 3] = a1 - b1;
+// Uniformly partitioned overlap-save convolution of the velvet tail. L and R
+// travel as the real and imaginary parts of one complex signal, so a single
+// FFT per partition serves both channels. The tail starts one partition late,
+// which hides the block latency of the FFT.
+struct VelvetTailConvolver {
+    ComplexFFT fft;
+    std::shared_ptr<const VelvetTailSpectra> spectra;
+    std::vector<std::complex<float>> fdl;       // input spectra, newest at fdlPos
+    std::vector<std::complex<float>> prevBlock, curBlock, frame, tailOut;
+    int partitionSize = 0;
+    int maxPartitions = 0;
+    int fdlPos = 0;
+    int validFrames = 0;
+    int fill = 0;
+    bool prevValid = false;
+    bool tailValid = false;
+
+    void prepare(int blockSize, int partitions) {
+        partitionSize = blockSize;
+        maxPartitions = std::max(1, partitions);
+        fft.prepare(2 * blockSize);
+        fdl.assign((size_t)maxPartitions * 2 * blockSize, { 0.0f, 0.0f });
+        prevBlock.assign(blockSize, { 0.0f, 0.0f });
+        curBlock.assign(blockSize, { 0.0f, 0.0f });
+        frame.assign(2 * blockSize, { 0.0f, 0.0f });
+        tailOut.assign(blockSize, { 0.0f, 0.0f });
+        reset();
     }
-    for (int i = 0; i < 16; i += 8) {
-        for (int j = 0; j < 4; ++j) {
-            float a = x[i + j]; float b = x[i + j + 4]; x[i + j] = a + b; x[i + j + 4] = a - b;
+    void setSpectra(std::shared_ptr<const VelvetTailSpectra> s) { spectra = std::move(s); reset(); }
+    void reset() { fdlPos = 0; validFrames = 0; fill = 0; prevValid = false; tailValid = false; }
+
+    // Adds the tail response to the interleaved accumulator acc (2 * n floats).
+    void process(const float* inL, const float* inR, float* acc, int n) {
+        int k = 0;
+        while (k < n) {
+            const int run = std::min(n - k, partitionSize - fill);
+            if (tailValid) {
+                for (int i = 0; i < run; ++i) {
+                    acc[2 * (k + i)] += tailOut[fill + i].real();
+                    acc[2 * (k + i) + 1] += tailOut[fill + i].imag();
+                }
+            }
+            for (int i = 0; i < run; ++i) curBlock[fill + i] = { inL[k + i], inR[k + i] };
+            fill += run;
+            k += run;
+            if (fill == partitionSize) { computeNextBlock(); fill = 0; }
         }
     }
-    for (int i = 0; i < 8; ++i) { float a = x[i]; float b = x[i + 8]; x[i] = a + b; x[i + 8] = a - b; }
-    for (int i = 0; i < 16; ++i) x[i] *= 0.25f;
-}
-static inline void matrixHouseholder(float* x) {
-    float sum = 0.0f;
-    for (int i = 0; i < 16; ++i) sum += x[i];
-    float u = -2.0f / 16.0f;
-    float s = sum * u;
+private:
+    void computeNextBlock() {
+        const int B = partitionSize;
+        const int N = 2 * B;
+        if (prevValid) std::copy(prevBlock.begin(), prevBlock.end(), frame.begin());
+        else std::fill(frame.begin(), frame.begin() + B, std::complex<float>(0.0f, 0.0f));
+        std::copy(curBlock.begin(), curBlock.end(), frame.begin() + B);
+        std::swap(prevBlock, curBlock);
+        prevValid = true;
+
+        fdlPos = (fdlPos + 1) % maxPartitions;
+        std::complex<float>* newest = fdl.data() + (size_t)fdlPos * N;
+        std::copy(frame.begin(), frame.end(), newest);
+        fft.forward(newest);
+        validFrames = std::min(validFrames + 1, maxPartitions);
+
+        std::fill(frame.begin(), frame.end(), std::complex<float>(0.0f, 0.0f));
+        const int parts = spectra ? std::min(spectra->numPartitions, validFrames) : 0;
+        for (int p = 0; p < parts; ++p) {
+            const std::complex<float>* x = fdl.data() + (size_t)((fdlPos - p + maxPartitions) % maxPartitions) * N;
+            const std::complex<float>* h = spectra->bins.data() + (size_t)p * N;
+            for (int i = 0; i < N; ++i) {
+                const float re = x[i].real() * h[i].real() - x[i].imag() * h[i].imag();
+                const float im = x[i].real() * h[i].imag() + x[i].imag() * h[i].real();
+                frame[i] = { frame[i].real() + re, frame[i].imag() + im };
+            }
+        }
+        fft.inverse(frame.data());
+        std::copy(frame.begin() + B, frame.end(), tailOut.begin());
+        tailValid = true;
+    }
+};
+
+// Velvet pre-diffusion with selectable sequence length. Short sequences run
+// entirely as block sparse FIR; long ones render the first partition as
+// sparse FIR and the rest with VelvetTailConvolver. Which backend a length
+// uses is measured once per process and sample rate.
+struct VelvetDiffuser {
+    static constexpr int NUM_LENGTHS = 5;
+    static constexpr float LENGTHS_MS[NUM_LENGTHS] = { 50.0f, 100.0f, 200.0f, 350.0f, 500.0f };
+
+    struct Variant {
+        std::shared_ptr<const std::vector<VelvetNoiseDiffuser::Tap>> taps;
+        std::shared_ptr<const VelvetTailSpectra> tail; // null: pure time domain
+        int headTaps = 0;
+    };
+    struct BackendChoice { bool useFFT = false; double timeDomainNs = 0.0; double fftNs = 0.0; };
+
+    VelvetBlockDiffuser history;
+    VelvetTailConvolver tail;
+    std::array<Variant, NUM_LENGTHS> variants;
+    std::array<BackendChoice, NUM_LENGTHS> choices;
+    std::vector<float> accum;
+    int active = 0;
+    float amount = 0.0f;
+
+    static int partitionSizeFor(float fs) {
+        int size = 1024;
+        while ((float)size * REFERENCE_SAMPLE_RATE < fs * 768.0f) size *= 2; // ~21 ms partitions
+        return size;
+    }
+
+    void prepare(float fs, bool calibrate = true) {
+        const int B = partitionSizeFor(fs);
+        int maxDelay = 1, maxPartitions = 1;
+        for (int i = 0; i < NUM_LENGTHS; ++i) {
+            if (calibrate) choices[i] = chooseBackend(fs, i);
+            Variant& v = variants[i];
+            v = makeVariant(fs, i, calibrate && choices[i].useFFT);
+            for (const auto& t : *v.taps) maxDelay = std::max(maxDelay, t.delay);
+            if (v.tail) maxPartitions = std::max(maxPartitions, v.tail->numPartitions);
+        }
+        history.prepare(maxDelay);
+        tail.prepare(B, maxPartitions);
+        accum.assign((size_t)PROCESS_BLOCK * 2, 0.0f);
+        tail.setSpectra(variants[active].tail);
+        reset();
+    }
+    void setAmount(float a) { amount = a; }
+    void setLength(int index) {
+        index = std::clamp(index, 0, NUM_LENGTHS - 1);
+        if (index == active) return;
+        active = index;
+        tail.setSpectra(variants[active].tail);
+    }
+    bool isUsingFFT() const { return variants[active].tail != nullptr; }
+    const BackendChoice& getBackendChoice(int index) const { return choices[std::clamp(index, 0, NUM_LENGTHS - 1)]; }
+
+    // Every length's taps and spectra at one rate.
+    using Tables = std::array<Variant, NUM_LENGTHS>;
+
+    // Measures every length at fs ahead of time and builds its tables. The
+    // shared caches only hold weak references, so the caller must keep the
+    // result: while it does, a prepare() at that rate (e.g. a quality switch
+    // on the audio thread) finds everything cached and neither measures nor
+    // allocates tables, though it still takes the caches' locks.
+    static Tables calibrate(float fs) {
+        Tables tables;
+        for (int i = 0; i < NUM_LENGTHS; ++i) tables[i] = makeVariant(fs, i, chooseBackend(fs, i).useFFT);
+        return tables;
+    }
+    void reset() { history.reset(); tail.reset(); }
+
+    // n must not exceed PROCESS_BLOCK. In-place use (out == in) is allowed.
+    void process(const float* inL, const float* inR, float* outL, float* outR, int n) {
+        const Variant& v = variants[active];
+        if (amount < 0.01f || !v.taps || history.lanes.empty()) {
+            if (outL != inL) std::copy(inL, inL + n, outL);
+            if (outR != inR) std::copy(inR, inR + n, outR);
+            return;
+        }
+        float* acc = accum.data();
+        std::fill(acc, acc + 2 * n, 0.0f);
+        const float* x = history.write(inL, inR, n);
+        history.accumulate(v.taps->data(), v.headTaps, x, acc, n);
+        if (v.tail) tail.process(inL, inR, acc, n);
+        history.advance(n);
+
+        const float dry = 1.0f - amount;
+        for (int k = 0; k < n; ++k) {
+            float l = inL[k], r = inR[k];
+            outL[k] = l * dry + acc[2 * k] * amount;
+            outR[k] = r * dry + acc[2 * k + 1] * amount;
+        }
+    }
+
+private:
+    static Variant makeVariant(float fs, int lengthIndex, bool useFFT) {
+        Variant v;
+        v.taps = VelvetNoiseDiffuser::sharedTaps(fs, LENGTHS_MS[lengthIndex]);
+        v.headTaps = (int)v.taps->size();
+        if (useFFT) useTail(v, fs, partitionSizeFor(fs));
+        return v;
+    }
+    static void useTail(Variant& v, float fs, int B) {
+        std::pair<int, int> key((int)std::lround(fs), (int)v.taps->size());
+        auto taps = v.taps;
+        v.tail = SharedTables::instance<std::pair<int, int>, VelvetTailSpectra>().get(key, [taps, B] { return VelvetTailSpectra::build(*taps, B); });
+        v.headTaps = 0;
+        while (v.headTaps < (int)v.taps->size() && (*v.taps)[v.headTaps].delay < B) v.headTaps++;
+    }
+
+    // Times both backends on noise and keeps the faster. Results live for
+    // the whole process, one entry per (sample rate, length).
+    static BackendChoice chooseBackend(float fs, int lengthIndex) {
+        static std::mutex mutex;
+        static std::map<std::pair<int, int>, BackendChoice> results;
+        std::pair<int, int> key((int)std::lround(fs), lengthIndex);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = results.find(key);
+        if (it != results.end()) return it->second;
+        BackendChoice choice;
+        choice.timeDomainNs = benchmark(fs, lengthIndex, false);
+        choice.fftNs = benchmark(fs, lengthIndex, true);
+        choice.useFFT = choice.fftNs < choice.timeDomainNs;
+        results[key] = choice;
+        return choice;
+    }
+    static double benchmark(float fs, int lengthIndex, bool useFFT) {
+        VelvetDiffuser d;
+        d.prepare(fs, false);
+        d.setLength(lengthIndex);
+        if (useFFT) {
+            useTail(d.variants[lengthIndex], fs, partitionSizeFor(fs));
+            d.tail.prepare(partitionSizeFor(fs), d.variants[lengthIndex].tail->numPartitions);
+            d.tail.setSpectra(d.variants[lengthIndex].tail);
+        }
+        d.setAmount(1.0f);
+        std::vector<float> l(PROCESS_BLOCK), r(PROCESS_BLOCK), outL(PROCESS_BLOCK), outR(PROCESS_BLOCK);
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+        for (int i = 0; i < PROCESS_BLOCK; ++i) { l[i] = noise(gen); r[i] = noise(gen); }
+        // Fill the history first: taps older than the last reset are skipped.
+        const int warmup = d.history.historyLen / PROCESS_BLOCK + 1;
+        for (int b = 0; b < warmup; ++b) d.process(l.data(), r.data(), outL.data(), outR.data(), PROCESS_BLOCK);
+        const int blocks = std::max(8, (int)(fs * 0.1f) / PROCESS_BLOCK);
+        double best = 1.0e300;
+        for (int run = 0; run < 3; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            for (int b = 0; b < blocks; ++b) d.process(l.data(), r.data(), outL.data(), outR.data(), PROCESS_BLOCK);
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+        }
+        return best / (double)(blocks * PROCESS_BLOCK);
+    }
+};
+
+// --- Image-Source Early Reflections ---
+// Surface a reflection hit last; each group shares one absorption filter.
+enum ERSurface { ER_FLOOR = 0, ER_CEILING, ER_SIDE, ER_FRONT_BACK, ER_NUM_SURFACES };
+
+struct ERTap {
+    int delaySamples = 0; // path difference to the direct sound, pre-delay excluded
+    float gain = 0.0f;    // broadband; the last bounce is left to the surface filter
+    float panL = 0.5f;
+    float panR = 0.5f;
+    int surface = ER_SIDE;
+};
+
+static constexpr int MIN_ER_ORDER = 3;
+static constexpr int MAX_ER_ORDER = 6;
+static constexpr int MAX_ER_TAPS = 512; // order 6 lattice has 376 reflections
+
+struct ERGeometry {
+    float W = 10.0f, D = 10.0f, H = 5.0f;
+    float sx = 0.0f, sy = 0.0f, sz = 0.0f; // source, room centred on the origin
+    float lx = 0.0f, ly = 0.0f, lz = 0.0f; // listener
+    float diffusion = 0.0f;
+    float fs = 48000.0f;
+    int shape = 0;
+    int order = MIN_ER_ORDER;
+
+    // Millimetre resolution is far below one sample at any supported rate.
+    std::array<int, 13> key() const {
+        auto mm = [](float v) { return (int)std::lround(v * 1000.0f); };
+        return { mm(W), mm(D), mm(H), mm(sx), mm(sy), mm(sz), mm(lx), mm(ly), mm(lz),
+                 mm(diffusion), (int)std::lround(fs), shape, order };
+    }
+};
+
+namespace ImageSourceSolver {
+    // Non-shoebox rooms are approximated by a shoebox with adjusted
+    // dimensions, per-surface reflectance and a deterministic path scatter
+    // that stands in for curved or tilted walls.
+    struct ShapeApprox {
+        float wScale, dScale, hScale;
+        float sideRefl, fbRefl, floorRefl, ceilRefl;
+        float scatter;
+    };
+    inline const ShapeApprox& shapeApprox(int shape) {
+        static const ShapeApprox table[] = {
+            { 1.00f, 1.00f, 1.00f, 0.80f, 0.80f, 0.80f, 0.80f, 0.00f }, // Shoe-box
+            { 1.00f, 1.00f, 0.80f, 0.80f, 0.80f, 0.80f, 0.95f, 0.03f }, // Dome: focusing ceiling
+            { 1.20f, 1.00f, 1.00f, 0.80f, 0.70f, 0.80f, 0.80f, 0.01f }, // Fan: splayed walls
+            { 0.90f, 0.90f, 1.00f, 0.90f, 0.90f, 0.80f, 0.80f, 0.05f }, // Cylinder
+            { 1.00f, 1.00f, 0.60f, 0.75f, 0.75f, 0.80f, 0.70f, 0.02f }, // Pyramid
+            { 1.00f, 1.00f, 1.00f, 0.90f, 0.90f, 0.90f, 0.90f, 0.00f }, // Tesseract
+            { 1.00f, 1.00f, 1.00f, 0.80f, 0.80f, 0.80f, 0.80f, 0.15f }, // Chaos
+        };
+        return table[std::clamp(shape, 0, 6)];
+    }
+
+    // Position of the n-th image of coordinate s in a room spanning
+    // [-L/2, L/2]. |n| is the number of reflections on that axis.
+    inline float imageCoord(int n, float s, float L) {
+        float u = s + 0.5f * L;
+        float img = (n & 1) ? (float)(n + 1) * L - u : (float)n * L + u;
+        return img - 0.5f * L;
+    }
+
+    inline float scatterNoise(int i, int j, int k) {
+        uint32_t h = (uint32_t)(i * 73856093) ^ (uint32_t)(j * 19349663) ^ (uint32_t)(k * 83492791);
+        h ^= h >> 13; h *= 0x5bd1e995u; h ^= h >> 15;
+        return (float)(h & 0xffffu) / 32767.5f - 1.0f;
+    }
+
+    // All reflections up to geometry.order, sorted by delay. Levels are
+    // normalised to the energy of the first-order set so the order only
+    // changes density, not loudness.
+    inline std::vector<ERTap> solve(const ERGeometry& g) {
+        const ShapeApprox& sh = shapeApprox(g.shape);
+        const float W = std::max(1.0f, g.W * sh.wScale);
+        const float D = std::max(1.0f, g.D * sh.dScale);
+        const float H = std::max(1.0f, g.H * sh.hScale);
+        const float sx = std::clamp(g.sx, -0.49f * W, 0.49f * W);
+        const float sy = std::clamp(g.sy, -0.49f * H, 0.49f * H);
+        const float sz = std::clamp(g.sz, -0.49f * D, 0.49f * D);
+        // The scaled room can be smaller than the one the positions were
+        // placed in; keep the listener inside it as well.
+        const float lx = std::clamp(g.lx, -0.49f * W, 0.49f * W);
+        const float ly = std::clamp(g.ly, -0.49f * H, 0.49f * H);
+        const float lz = std::clamp(g.lz, -0.49f * D, 0.49f * D);
+        const float order = (float)std::clamp(g.order, 1, MAX_ER_ORDER);
+        const int N = (int)order;
+        const float maxPathDiff = MAX_ER_PATH_SECONDS * SPEED_OF_SOUND;
+        const float levelScale = 1.0f - g.diffusion * 0.3f;
+
+        float dxd = sx - lx, dyd = sy - ly, dzd = sz - lz;
+        const float dDirect = std::sqrt(dxd * dxd + dyd * dyd + dzd * dzd);
+
+        std::vector<ERTap> taps;
+        taps.reserve(MAX_ER_TAPS);
+        float firstOrderEnergy = 0.0f, totalEnergy = 0.0f;
+        for (int i = -N; i <= N; ++i) {
+            const float ix = imageCoord(i, sx, W) - lx;
+            for (int j = -N + std::abs(i); j <= N - std::abs(i); ++j) {
+                const float iy = imageCoord(j, sy, H) - ly;
+                const int kMax = N - std::abs(i) - std::abs(j);
+                for (int k = -kMax; k <= kMax; ++k) {
+                    const int bounces = std::abs(i) + std::abs(j) + std::abs(k);
+                    if (bounces == 0) continue; // direct sound is not an ER
+                    const float iz = imageCoord(k, sz, D) - lz;
+                    float path = std::sqrt(ix * ix + iy * iy + iz * iz);
+                    if (sh.scatter > 0.0f) path *= 1.0f + sh.scatter * scatterNoise(i, j, k) * (float)bounces / order;
+                    float pathDiff = std::max(0.1f, path - dDirect);
+                    if (pathDiff > maxPathDiff) continue;
+
+                    // Floor is y < 0, ceiling y > 0.
+                    int floorHits = (j < 0) ? (std::abs(j) + 1) / 2 : std::abs(j) / 2;
+                    int ceilHits = std::abs(j) - floorHits;
+                    float refl = 1.0f;
+                    for (int b = 0; b < std::abs(i); ++b) refl *= sh.sideRefl;
+                    for (int b = 0; b < std::abs(k); ++b) refl *= sh.fbRefl;
+                    for (int b = 0; b < floorHits; ++b) refl *= sh.floorRefl;
+                    for (int b = 0; b < ceilHits; ++b) refl *= sh.ceilRefl;
+
+                    // Walking from the listener towards the image, the first
+                    // wall plane crossed is the last surface the sound hit.
+                    // Its loss is applied spectrally by the group filter.
+                    int surface = ER_SIDE;
+                    float nearest = std::numeric_limits<float>::max();
+                    auto consider = [&](int n, float delta, float half, float l, int posSurface, int negSurface) {
+                        if (n == 0 || delta == 0.0f) return;
+                        float tCross = ((delta > 0.0f ? half : -half) - l) / delta;
+                        if (tCross < nearest) { nearest = tCross; surface = (delta > 0.0f) ? posSurface : negSurface; }
+                    };
+                    consider(i, ix, 0.5f * W, lx, ER_SIDE, ER_SIDE);
+                    consider(j, iy, 0.5f * H, ly, ER_CEILING, ER_FLOOR);
+                    consider(k, iz, 0.5f * D, lz, ER_FRONT_BACK, ER_FRONT_BACK);
+                    const float lastRefl[ER_NUM_SURFACES] = { sh.floorRefl, sh.ceilRefl, sh.sideRefl, sh.fbRefl };
+                    refl /= lastRefl[surface];
+
+                    ERTap t;
+                    t.surface = surface;
+                    t.delaySamples = std::max(1, (int)(pathDiff / SPEED_OF_SOUND * g.fs));
+                    t.gain = refl / (1.0f + path * 0.5f) * levelScale;
+                    float p = std::clamp(ix / std::max(path, 1.0e-3f), -1.0f, 1.0f);
+                    t.panL = 0.5f - 0.4f * p;
+                    t.panR = 0.5f + 0.4f * p;
+                    totalEnergy += t.gain * t.gain;
+                    if (bounces == 1) firstOrderEnergy += t.gain * t.gain;
+                    taps.push_back(t);
+                }
+            }
+        }
+        std::sort(taps.begin(), taps.end(), [](const ERTap& a, const ERTap& b) { return a.delaySamples < b.delaySamples; });
+        if ((int)taps.size() > MAX_ER_TAPS) taps.resize(MAX_ER_TAPS);
+        if (totalEnergy > 0.0f) {
+            const float norm = std::sqrt(firstOrderEnergy / totalEnergy);
+            for (auto& t : taps) t.gain *= norm;
+        }
+        return taps;
+    }
+}
+
+// Runs ImageSourceSolver on its own thread. The audio thread posts geometry
+// through one triple buffer and picks up finished tap lists from another;
+// neither side locks. Solved geometries are cached, so moving back to a
+// previous setting is a lookup.
+class ERSolverThread {
+public:
+    struct Result {
+        std::vector<ERTap> taps;
+        uint32_t serial = 0;
+    };
+
+    // Without the worker only solveNow() is usable until startWorker().
+    explicit ERSolverThread(bool withWorker = true) {
+        results.forEachSlot([](Result& r) { r.taps.reserve(MAX_ER_TAPS); });
+        if (withWorker) startWorker();
+    }
+    ~ERSolverThread() {
+        if (!worker.joinable()) return;
+        quit.store(true);
+        wake.post();
+        worker.join();
+    }
+    ERSolverThread(const ERSolverThread&) = delete;
+    ERSolverThread& operator=(const ERSolverThread&) = delete;
+
+    // Not realtime-safe.
+    void startWorker() {
+        if (!worker.joinable()) worker = std::thread([this] { run(); });
+    }
+    bool hasWorker() const { return worker.joinable(); }
+
+    // Audio thread: lock-free and never blocks.
+    void request(const ERGeometry& g) {
+        requests.writeBuffer() = g;
+        requests.publish();
+        wake.post();
+    }
+    // Solves on the calling thread (offline rendering).
+    void solveNow(const ERGeometry& g) { publish(lookup(g)); }
+
+    // Audio thread: true if a newer tap list is available through latest().
+    bool poll() { return results.update(); }
+    const Result& latest() const { return results.read(); }
+
+private:
+    static constexpr size_t MAX_CACHED = 64;
+
+    std::shared_ptr<const std::vector<ERTap>> lookup(const ERGeometry& g) {
+        std::lock_guard<std::mutex> guard(cacheLock);
+        auto k = g.key();
+        auto it = cache.find(k);
+        if (it != cache.end()) return it->second;
+        if (cache.size() >= MAX_CACHED) cache.clear();
+        auto solved = std::make_shared<const std::vector<ERTap>>(ImageSourceSolver::solve(g));
+        cache.emplace(k, solved);
+        return solved;
+    }
+    void publish(const std::shared_ptr<const std::vector<ERTap>>& taps) {
+        std::lock_guard<std::mutex> guard(publishLock);
+        Result& r = results.writeBuffer();
+        r.taps.assign(taps->begin(), taps->end());
+        r.serial = ++serial;
+        results.publish();
+    }
+    // One post per request; posts for requests already taken with an
+    // earlier one find nothing new and go back to waiting.
+    void run() {
+        for (;;) {
+            wake.wait();
+            if (quit.load()) break;
+            if (!requests.update()) continue;
+            publish(lookup(requests.read()));
+        }
+    }
+
+    TripleBuffer<ERGeometry> requests;
+    TripleBuffer<Result> results;
+    std::mutex cacheLock, publishLock;
+    WakeSemaphore wake;
+    std::map<std::array<int, 13>, std::shared_ptr<const std::vector<ERTap>>> cache;
+    uint32_t serial = 0;
+    std::atomic<bool> quit{ false };
+    std::thread worker;
+};
+
+// Block renderer for the image-source taps. The input ring keeps a copy of
+// its first PROCESS_BLOCK samples past the end, so every tap reads one
+// contiguous span per block. Taps are processed tap-major with L/R as two
+// interleaved lanes, and taps that land on the same sample are merged.
+// Each surface group is summed on its own and filtered once.
+struct EarlyReflections {
+    LargeFloatBuffer predelayBuffer; // ring of ringSize samples + PROCESS_BLOCK mirror
+    int ringSize = 0;
+    int preWritePos = 0;
+    int preValidSamples = 0;
+    float fs = 48000.0f;
+    struct RenderTap {
+        int delaySamples = 0;
+        float gainL = 0.0f;
+        float gainR = 0.0f;
+    };
+    // Solver output with pre-delay and pan applied, merged, one list per surface.
+    std::array<std::vector<RenderTap>, ER_NUM_SURFACES> taps;
+    std::array<MaterialFilter4Band, ER_NUM_SURFACES> surfaceFilterL, surfaceFilterR;
+    std::array<float, 2 * PROCESS_BLOCK> groupAccum{};
+    std::unique_ptr<ERSolverThread> solver;
+    int baseDelay = 0;
+    int order = MIN_ER_ORDER;
+    bool synchronous = false;
+    EarlyReflections() {}
+    void prepare(double sampleRate) {
+        fs = (float)sampleRate;
+        // Pre-delay is applied once on the input and once more on every tap.
+        double maxSeconds = 2.0 * MAX_PREDELAY_SECONDS + MAX_ER_PATH_SECONDS;
+        int size = (int)(maxSeconds * sampleRate) + 4096 + PROCESS_BLOCK;
+        if (predelayBuffer.size() < size) predelayBuffer.resize(size, 0.0f);
+        ringSize = (int)predelayBuffer.size() - PROCESS_BLOCK;
+        for (auto& list : taps) { list.reserve(MAX_ER_TAPS); list.clear(); }
+        // An engine that is synchronous from the start never needs the
+        // background solver.
+        if (!solver) solver = std::make_unique<ERSolverThread>(!synchronous);
+        else if (!synchronous) solver->startWorker();
+        reset();
+    }
+    void reset() {
+        preWritePos = 0;
+        preValidSamples = 0;
+        for (int s = 0; s < ER_NUM_SURFACES; ++s) { surfaceFilterL[s].reset(); surfaceFilterR[s].reset(); }
+    }
+    int getNumTaps() const {
+        int total = 0;
+        for (const auto& list : taps) total += (int)list.size();
+        return total;
+    }
+    // Per-band absorption of each surface group (index by ERSurface).
+    void setSurfaceAbsorption(const std::array<std::array<float, 6>, ER_NUM_SURFACES>& absorption) {
+        for (int s = 0; s < ER_NUM_SURFACES; ++s) {
+            std::array<float, 6> reflect;
+            float maxR = 0.0f;
+            for (int b = 0; b < 6; ++b) {
+                reflect[b] = std::sqrt(1.0f - std::clamp(absorption[s][b], 0.0f, 0.99f));
+                maxR = std::max(maxR, reflect[b]);
+            }
+            surfaceFilterL[s].setCoeffs(reflect, maxR, fs);
+            surfaceFilterR[s].setCoeffs(reflect, maxR, fs);
+        }
+    }
+    void setOrder(int newOrder) { order = std::clamp(newOrder, MIN_ER_ORDER, MAX_ER_ORDER); }
+    // Offline rendering solves inline so the result does not depend on timing.
+    // Set before prepare() to skip the solver thread; an engine prepared that
+    // way keeps solving inline until it is prepared again asynchronous.
+    void setSynchronous(bool shouldSolveInline) { synchronous = shouldSolveInline; }
+
+    void updateGeometry(float W, float D, float H, float predelayMs, float srcH, float diffusion, float dist, float pan, int shape) {
+        baseDelay = (int)(predelayMs * 0.001f * fs);
+        ERGeometry g;
+        g.W = W; g.D = D; g.H = H;
+        g.sx = pan * (W * 0.45f);
+        g.sy = (srcH - 0.5f) * H;
+        g.sz = (dist - 0.5f) * D;
+        g.lx = 0.0f; g.ly = 0.0f; g.lz = -D * 0.45f;
+        g.diffusion = diffusion;
+        g.fs = fs;
+        g.shape = shape;
+        g.order = order;
+        if (!solver) return;
+        if (synchronous || !solver->hasWorker()) solver->solveNow(g);
+        else solver->request(g);
+        solver->poll();
+        applyTaps();
+    }
+    // Called once per block on the audio thread.
+    void pollSolver() {
+        if (solver && solver->poll()) applyTaps();
+    }
+    void applyTaps() {
+        const auto& solved = solver->latest().taps;
+        // Spans must not reach into the block being written.
+        const int maxDelay = ringSize - PROCESS_BLOCK;
+        for (auto& list : taps) list.clear();
+        for (const auto& t : solved) {
+            RenderTap r;
+            r.delaySamples = std::clamp(2 * baseDelay + t.delaySamples, 1, maxDelay);
+            r.gainL = t.gain * t.panL;
+            r.gainR = t.gain * t.panR;
+            auto& list = taps[std::clamp(t.surface, 0, ER_NUM_SURFACES - 1)];
+            if (!list.empty() && list.back().delaySamples == r.delaySamples) {
+                list.back().gainL += r.gainL;
+                list.back().gainR += r.gainR;
+            }
+            else list.push_back(r);
+        }
+    }
+    // Renders n <= PROCESS_BLOCK samples into outLR (interleaved L/R, 2 * n floats).
+    void process(const float* input, float* outLR, int n) {
+        float* ring = predelayBuffer.data();
+        for (int k = 0; k < n; ++k) {
+            int idx = preWritePos + k;
+            if (idx >= ringSize) idx -= ringSize;
+            ring[idx] = input[k];
+            if (idx < PROCESS_BLOCK) ring[ringSize + idx] = input[k];
+        }
+        std::fill(outLR, outLR + 2 * n, 0.0f);
+        for (int s = 0; s < ER_NUM_SURFACES; ++s) {
+            const auto& list = taps[s];
+            if (list.empty()) continue;
+            float* acc = groupAccum.data();
+            std::fill(acc, acc + 2 * n, 0.0f);
+            const int numTaps = (int)list.size();
+            int t = 0;
+            // Sorted by delay: if the fourth tap has full history, all four do.
+            for (; t + 4 <= numTaps && list[t + 3].delaySamples <= preValidSamples; t += 4)
+                renderTaps4(&list[t], ring, acc, n);
+            for (; t < numTaps; ++t) {
+                // Once a tap starts past the end of the block, so do all that follow.
+                const int start = std::max(0, list[t].delaySamples - preValidSamples);
+                if (start >= n) break;
+                renderTap(list[t], ring, acc, start, n);
+            }
+            for (int k = 0; k < n; ++k) {
+                outLR[2 * k] += surfaceFilterL[s].process(acc[2 * k]);
+                outLR[2 * k + 1] += surfaceFilterR[s].process(acc[2 * k + 1]);
+            }
+        }
+        preWritePos += n;
+        if (preWritePos >= ringSize) preWritePos -= ringSize;
+        preValidSamples = std::min(preValidSamples + n, ringSize);
+    }
+
+private:
+    const float* spanFor(const RenderTap& tap, const float* ring) const {
+        int r = preWritePos - tap.delaySamples;
+        if (r < 0) r += ringSize;
+        return ring + r;
+    }
+    void renderTap(const RenderTap& tap, const float* ring, float* outLR, int start, int n) const {
+        const float* src = spanFor(tap, ring);
+        const float gL = tap.gainL, gR = tap.gainR;
+        int k = start;
+#if FDN_HAS_SSE2
+        const __m128 g = _mm_setr_ps(gL, gR, gL, gR);
+        for (; k + 4 <= n; k += 4) {
+            const __m128 x = _mm_loadu_ps(src + k);
+            float* o = outLR + 2 * k;
+            _mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), _mm_mul_ps(_mm_unpacklo_ps(x, x), g)));
+            _mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_mul_ps(_mm_unpackhi_ps(x, x), g)));
+        }
+#endif
+        for (; k < n; ++k) {
+            outLR[2 * k] += src[k] * gL;
+            outLR[2 * k + 1] += src[k] * gR;
+        }
+    }
+    // Four taps per pass so the accumulator is loaded and stored once.
+    void renderTaps4(const RenderTap* group, const float* ring, float* outLR, int n) const {
+        const float* s0 = spanFor(group[0], ring);
+        const float* s1 = spanFor(group[1], ring);
+        const float* s2 = spanFor(group[2], ring);
+        const float* s3 = spanFor(group[3], ring);
+        int k = 0;
+#if FDN_HAS_SSE2
+        const __m128 g0 = _mm_setr_ps(group[0].gainL, group[0].gainR, group[0].gainL, group[0].gainR);
+        const __m128 g1 = _mm_setr_ps(group[1].gainL, group[1].gainR, group[1].gainL, group[1].gainR);
+        const __m128 g2 = _mm_setr_ps(group[2].gainL, group[2].gainR, group[2].gainL, group[2].gainR);
+        const __m128 g3 = _mm_setr_ps(group[3].gainL, group[3].gainR, group[3].gainL, group[3].gainR);
+        for (; k + 4 <= n; k += 4) {
+            float* o = outLR + 2 * k;
+            __m128 lo = _mm_loadu_ps(o), hi = _mm_loadu_ps(o + 4);
+            __m128 x = _mm_loadu_ps(s0 + k);
+            lo = _mm_add_ps(lo, _mm_mul_ps(_mm_unpacklo_ps(x, x), g0)); hi = _mm_add_ps(hi, _mm_mul_ps(_mm_unpackhi_ps(x, x), g0));
+            x = _mm_loadu_ps(s1 + k);
+            lo = _mm_add_ps(lo, _mm_mul_ps(_mm_unpacklo_ps(x, x), g1)); hi = _mm_add_ps(hi, _mm_mul_ps(_mm_unpackhi_ps(x, x), g1));
+            x = _mm_loadu_ps(s2 + k);
+            lo = _mm_add_ps(lo, _mm_mul_ps(_mm_unpacklo_ps(x, x), g2)); hi = _mm_add_ps(hi, _mm_mul_ps(_mm_unpackhi_ps(x, x), g2));
+            x = _mm_loadu_ps(s3 + k);
+            lo = _mm_add_ps(lo, _mm_mul_ps(_mm_unpacklo_ps(x, x), g3)); hi = _mm_add_ps(hi, _mm_mul_ps(_mm_unpackhi_ps(x, x), g3));
+            _mm_storeu_ps(o, lo);
+            _mm_storeu_ps(o + 4, hi);
+        }
+#endif
+        for (; k < n; ++k) {
+            outLR[2 * k] += s0[k] * group[0].gainL + s1[k] * group[1].gainL + s2[k] * group[2].gainL + s3[k] * group[3].gainL;
+            outLR[2 * k + 1] += s0[k] * group[0].gainR + s1[k] * group[1].gainR + s2[k] * group[2].gainR + s3[k] * group[3].gainR;
+        }
+    }
+};
+
+struct alignas(64) FDNChannel {
+    // buffer[ringSize + k] mirrors buffer[k], so the four Lagrange taps
+    // starting anywhere in the ring are contiguous.
+    static constexpr int READ_GUARD = 3;
+    LargeFloatBuffer buffer;
+    int ringSize = 0;
+    int writePos = 0;
+    int validSamples = 0;
+    MaterialFilter4Band materialFilter;
+    LoopAllpass loopAllpass1;
+    LoopAllpass loopAllpass2;
+    DCBlocker feedbackDCBlocker;
+    ParameterSmoother delaySmoother;
+    ParameterSmoother gainSmoother;
+    ParameterSmoother densitySmoother;
+    FDNChannel() {}
+    void prepare(double sampleRate) {
+        int size = (int)(MAX_DELAY_SECONDS * sampleRate) + 4096;
+        if (ringSize < size) {
+            buffer.resize((size_t)size + READ_GUARD, 0.0f);
+            ringSize = size;
+        }
+        loopAllpass1.setup(4096, (float)sampleRate);
+        loopAllpass2.setup(4096, (float)sampleRate);
+    }
+    inline void push(float sample) {
+        sample = feedbackDCBlocker.process(sample);
+        sample = antiDenormal(sample);
+        buffer[writePos] = sample;
+        if (writePos < READ_GUARD) buffer[ringSize + writePos] = sample;
+        writePos++;
+        if (writePos >= ringSize) writePos = 0;
+        if (validSamples < ringSize) validSamples++;
+    }
+    // Mean square of the last n samples written.
+    float recentMeanSquare(int n) const {
+        n = std::min(n, validSamples);
+        if (n <= 0) return 0.0f;
+        float acc = 0.0f;
+        int idx = writePos;
+        for (int k = 0; k < n; ++k) {
+            if (--idx < 0) idx = ringSize - 1;
+            acc += buffer[idx] * buffer[idx];
+        }
+        return acc / (float)n;
+    }
+    // Reads may be issued 'ahead' samples past the last push, as if those
+    // pushes had happened; the caller guarantees they would not be read.
+    inline int writePosAhead(int ahead) const {
+        const int w = writePos + ahead;
+        return (w >= ringSize) ? w - ringSize : w;
+    }
+    inline int validAhead(int ahead) const { return std::min(validSamples + ahead, ringSize); }
+    // True while a read this far back would reach samples not written since reset.
+    inline bool needsEpochRead(float modulatedDelay, int ahead = 0) const {
+        const int valid = validAhead(ahead);
+        return modulatedDelay + 2.0f > (float)valid && valid < ringSize;
+    }
+    inline float readEpoch(float readPos, int ahead = 0) const {
+        return LagrangeInterpolator::processEpoch(buffer.data(), ringSize, readPos, writePosAhead(ahead), validAhead(ahead));
+    }
+    // Scalar read; FDNEngine::readLineGroup does four lines at once.
+    inline float read(float modulatedDelay, int ahead = 0) const {
+        float r = (float)writePosAhead(ahead) - modulatedDelay;
+        if (r < 0.0f) r += (float)ringSize;
+        else if (r >= (float)ringSize) r -= (float)ringSize;
+        if (needsEpochRead(modulatedDelay, ahead)) return readEpoch(r, ahead);
+        return LagrangeInterpolator::process(buffer.data(), ringSize, r);
+    }
+    inline float getSmoothedGain() { return gainSmoother.getNext(); }
+    void setDensity(float amount, int samplesToSmooth) {
+        float g = amount * 0.6f;
+        densitySmoother.setTarget(g, samplesToSmooth);
+    }
+    inline float processFilter(float sample) { return processLoopAllpasses(processMaterial(sample)); }
+    inline float processMaterial(float sample) { return materialFilter.process(sample); }
+    inline float processLoopAllpasses(float sample) {
+        float g = densitySmoother.getNext();
+        loopAllpass1.setGain(g);
+        loopAllpass2.setGain(g);
+        float out = loopAllpass1.process(sample);
+        out = loopAllpass2.process(out);
+        return out;
+    }
+    void reset() {
+        writePos = 0;
+        validSamples = 0;
+        materialFilter.reset();
+        loopAllpass1.reset();
+        loopAllpass2.reset();
+        feedbackDCBlocker.reset();
+        delaySmoother.snapTo(1000.0f);
+        gainSmoother.snapTo(0.0f);
+        densitySmoother.snapTo(0.0f);
+    }
+};
+
+// --- MATRIX FUNCTIONS ---
+static inline void matrixHadamard(float* x) {
+    for (int i = 0; i < 16; i += 2) { float a = x[i]; float b = x[i + 1]; x[i] = a + b; x[i + 1] = a - b; }
+    for (int i = 0; i < 16; i += 4) {
+        float a0 = x[i]; float b0 = x[i + 2]; x[i] = a0 + b0; x[i + 2] = a0 - b0;
+        float a1 = x[i + 1]; float b1 = x[i + 3]; x[i + 1] = a1 + b1; x[i + 3] = a1 - b1;
+    }
+    for (int i = 0; i < 16; i += 8) {
+        for (int j = 0; j < 4; ++j) {
+            float a = x[i + j]; float b = x[i + j + 4]; x[i + j] = a + b; x[i + j + 4] = a - b;
+        }
+    }
+    for (int i = 0; i < 8; ++i) { float a = x[i]; float b = x[i + 8]; x[i] = a + b; x[i + 8] = a - b; }
+    for (int i = 0; i < 16; ++i) x[i] *= 0.25f;
+}
+static inline void matrixHouseholder(float* x) {
+    float sum = 0.0f;
+    for (int i = 0; i < 16; ++i) sum += x[i];
+    float u = -2.0f / 16.0f;
+    float s = sum * u;
     for (int i = 0; i < 16; ++i) x[i] += s;
 }
 static inline void matrixBlockPerm(float* x) {
@@ -793,57 +2281,466 @@ struct RT60Data {
     std::array<float, 6> decay = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
 };
 
+// Everything the UI shows about the running engine, published as one unit
+// so a reader never sees values from two different callbacks.
+struct AnalysisSnapshot {
+    static constexpr float IDLE_LEVEL = 1.0e-6f; // -120 dBFS
+
+    uint64_t sequence = 0;              // bumped on every publish
+    RT60Data rt60;
+    std::array<float, 2> peak{};        // per channel, over the last callback
+    std::array<float, 2> rms{};
+    float loopEnergy = 0.0f;            // mean square per line
+    bool idle = true;                   // output and loop below IDLE_LEVEL
+};
+
+// --- Parallel line groups ---
+inline void cpuRelax() {
+#if FDN_HAS_SSE2
+    _mm_pause();
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+    __asm__ __volatile__("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Sense-counting barrier for a fixed set of threads that are all running;
+// it only belongs between phases of one block. Waiting spins, then yields
+// once the wait is clearly longer than a phase, so a partner that was
+// preempted on the same core gets it back.
+class SpinBarrier {
+    static constexpr int SPINS_BEFORE_YIELD = 4096; // tens of microseconds
+    alignas(64) std::atomic<int> arrived{ 0 };
+    alignas(64) std::atomic<unsigned> generation{ 0 };
+    const int parties;
+public:
+    explicit SpinBarrier(int numParties) : parties(numParties) {}
+    void arriveAndWait() {
+        const unsigned gen = generation.load(std::memory_order_acquire);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) == parties - 1) {
+            arrived.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        for (int spins = 0; generation.load(std::memory_order_acquire) == gen; ++spins) {
+            if (spins < SPINS_BEFORE_YIELD) cpuRelax();
+            else std::this_thread::yield();
+        }
+    }
+};
+
+// Three worker threads plus the caller, one per line group. run() hands
+// the same job to all four and returns once every one has finished. Idle
+// workers spin briefly after a job (the next sub-block is usually close
+// behind) and then sleep until the next run(). The barriers spin, so the
+// workers run at audio-helper priority to stay ahead of everything that
+// could preempt them between two phases.
+class LineGroupWorkers {
+public:
+    static constexpr int NUM_GROUPS = 4;
+    using Job = void (*)(void* context, int group);
+
+    LineGroupWorkers() = default;
+    ~LineGroupWorkers() { stop(); }
+    LineGroupWorkers(const LineGroupWorkers&) = delete;
+    LineGroupWorkers& operator=(const LineGroupWorkers&) = delete;
+
+    // Not realtime-safe, but may run while the audio thread is in run()'s
+    // caller: the pool only shows up in running() once it is complete.
+    // Returns false on machines with fewer cores than groups.
+    bool start(bool pinToCores) {
+        if (!threads.empty()) return true;
+        const unsigned cores = std::thread::hardware_concurrency();
+        if (cores < (unsigned)NUM_GROUPS) return false;
+        stopping.store(false);
+        // Successive pools start on different cores so several instances
+        // do not all pile onto the same three.
+        static std::atomic<unsigned> nextCore{ 1 };
+        const unsigned firstCore = nextCore.fetch_add(NUM_GROUPS - 1);
+        for (int g = 1; g < NUM_GROUPS; ++g) {
+            threads.emplace_back([this, g] { workerLoop(g); });
+            if (pinToCores) pin(threads.back(), (firstCore + (unsigned)g - 1) % cores);
+        }
+        available.store(true, std::memory_order_release);
+        return true;
+    }
+    // Not while the audio thread may be in run().
+    void stop() {
+        if (threads.empty()) return;
+        available.store(false);
+        stopping.store(true);
+        for (size_t i = 0; i < threads.size(); ++i) wake.post();
+        for (auto& t : threads) t.join();
+        threads.clear();
+    }
+    bool running() const { return available.load(std::memory_order_acquire); }
+
+    // Audio thread; lock-free. The caller runs group 0.
+    void run(Job jobToRun, void* jobContext) {
+        job = jobToRun;
+        context = jobContext;
+        epoch.fetch_add(1);
+        // Any sleeper will do for any post: none of them can go back to
+        // sleep before all four have passed the barrier.
+        for (int n = sleepers.load(); n > 0; --n) wake.post();
+        job(context, 0);
+        phaseBarrier.arriveAndWait();
+    }
+    // For the job itself: all groups must call this the same number of times.
+    void sync() { phaseBarrier.arriveAndWait(); }
+
+private:
+    static constexpr auto SPIN_BEFORE_SLEEP = std::chrono::microseconds(200);
+
+    static void pin(std::thread& t, unsigned core) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+#else
+        (void)t; (void)core;
+#endif
+    }
+
+    void workerLoop(int group) {
+        setCurrentThreadPriority(ThreadPriority::AudioHelper);
+        ScopedFlushDenormals flushDenormals;
+        unsigned seen = epoch.load();
+        for (;;) {
+            const auto spinStart = std::chrono::steady_clock::now();
+            while (epoch.load() == seen && !stopping.load()) {
+                cpuRelax();
+                if (std::chrono::steady_clock::now() - spinStart > SPIN_BEFORE_SLEEP) {
+                    // Registered before the re-check, so run() either posts
+                    // for this worker or is seen to have moved the epoch.
+                    sleepers.fetch_add(1);
+                    while (epoch.load() == seen && !stopping.load()) wake.wait();
+                    sleepers.fetch_sub(1);
+                }
+            }
+            if (stopping.load()) return;
+            seen = epoch.load();
+            job(context, group);
+            phaseBarrier.arriveAndWait();
+        }
+    }
+
+    std::vector<std::thread> threads;
+    SpinBarrier phaseBarrier{ NUM_GROUPS };
+    std::atomic<unsigned> epoch{ 0 };
+    std::atomic<int> sleepers{ 0 };
+    std::atomic<bool> stopping{ false };
+    std::atomic<bool> available{ false };
+    WakeSemaphore wake;
+    Job job = nullptr;
+    void* context = nullptr;
+};
+
+// One background thread that runs a job whenever it is notified. Sleeps
+// straight away: its work arrives once per audio callback and has the rest
+// of the period to finish, so wake-up latency does not matter.
+class PipelineWorker {
+public:
+    using Job = void (*)(void* context);
+
+    PipelineWorker() = default;
+    ~PipelineWorker() { stop(); }
+    PipelineWorker(const PipelineWorker&) = delete;
+    PipelineWorker& operator=(const PipelineWorker&) = delete;
+
+    // Not realtime-safe.
+    void start(Job jobToRun, void* jobContext) {
+        if (running()) return;
+        job = jobToRun;
+        context = jobContext;
+        stopping.store(false);
+        thread = std::thread([this] { workerLoop(); });
+    }
+    void stop() {
+        if (!running()) return;
+        stopping.store(true);
+        wake.post();
+        thread.join();
+        thread = std::thread();
+    }
+    bool running() const { return thread.joinable(); }
+
+    // Audio thread: the job runs at least once after this call. Lock-free;
+    // the semaphore is only posted while the worker is (about to be) asleep.
+    void notify() {
+        requests.fetch_add(1);
+        if (sleeping.load()) wake.post();
+    }
+
+private:
+    void workerLoop() {
+        setCurrentThreadPriority(ThreadPriority::AudioHelper);
+        ScopedFlushDenormals flushDenormals;
+        unsigned seen = 0;
+        for (;;) {
+            // sleeping is raised before requests is checked and notify()
+            // bumps requests before checking sleeping, so one side always
+            // sees the other. A post that was not needed only costs one more
+            // trip round this loop.
+            sleeping.store(true);
+            while (requests.load() == seen && !stopping.load()) wake.wait();
+            sleeping.store(false);
+            if (stopping.load()) return;
+            seen = requests.load();
+            job(context);
+        }
+    }
+
+    std::thread thread;
+    std::atomic<unsigned> requests{ 0 };
+    std::atomic<bool> sleeping{ false };
+    std::atomic<bool> stopping{ false };
+    WakeSemaphore wake;
+    Job job = nullptr;
+    void* context = nullptr;
+};
+
+// Callback-load governor. Tier 0 is full quality; each tier above it is one
+// step cheaper. A step down needs the smoothed load above the down threshold
+// (or a single callback over its period); a step up needs it to stay below
+// the up threshold for a while. Both are held off right after a change so
+// the average can catch up with the new cost.
+class LoadGovernor {
+public:
+    static constexpr double SMOOTHING_SECONDS = 0.25;
+    static constexpr double DOWN_HOLD_SECONDS = 0.5;
+    static constexpr double UP_HOLD_SECONDS = 3.0;
+
+    // Loads are fractions of the callback period.
+    void setThresholds(float downLoad, float upLoad) {
+        down = downLoad;
+        up = std::min(upLoad, downLoad);
+    }
+    void setMaxTier(int highestTier) {
+        maxTier = std::max(0, highestTier);
+        if (tier > maxTier) setTier(maxTier);
+    }
+    void reset() {
+        smoothed = 0.0;
+        publishedLoad.store(0.0f, std::memory_order_relaxed);
+        setTier(0);
+    }
+
+    // Audio thread, once per callback.
+    void addCallback(double elapsedSeconds, double periodSeconds) {
+        if (periodSeconds <= 0.0) return;
+        const double instant = elapsedSeconds / periodSeconds;
+        smoothed += (1.0 - std::exp(-periodSeconds / SMOOTHING_SECONDS)) * (instant - smoothed);
+        publishedLoad.store((float)smoothed, std::memory_order_relaxed);
+        sinceChange += periodSeconds;
+        if ((smoothed > down || instant > 1.0) && tier < maxTier && sinceChange > DOWN_HOLD_SECONDS) setTier(tier + 1);
+        else if (smoothed < up && tier > 0 && sinceChange > UP_HOLD_SECONDS) setTier(tier - 1);
+    }
+
+    // Any thread.
+    float getLoad() const { return publishedLoad.load(std::memory_order_relaxed); }
+    int getTier() const { return publishedTier.load(std::memory_order_relaxed); }
+
+private:
+    void setTier(int newTier) {
+        tier = newTier;
+        sinceChange = 0.0;
+        publishedTier.store(newTier, std::memory_order_relaxed);
+    }
+
+    float down = 0.8f;
+    float up = 0.35f;
+    int maxTier = 0;
+    int tier = 0;
+    double smoothed = 0.0;
+    double sinceChange = 0.0;
+    std::atomic<float> publishedLoad{ 0.0f };
+    std::atomic<int> publishedTier{ 0 };
+};
+
+// Deadline statistics for an audio callback. The audio thread is the only
+// writer, so every counter is a plain load + store; a reader on another
+// thread may see one callback half-recorded, never a torn value.
+class CallbackStats {
+public:
+    static constexpr int LOAD_BUCKETS = 201;     // 1 % wide, last one is >= 200 %
+    static constexpr int TIME_BUCKETS_PER_OCTAVE = 4;
+    static constexpr int TIME_BUCKETS = 20 * TIME_BUCKETS_PER_OCTAVE; // 1 us .. ~1 s
+
+    struct Snapshot {
+        uint64_t callbacks = 0;
+        uint64_t overruns = 0;          // callbacks longer than their period
+        uint64_t physicsUpdates = 0;
+        double minMs = 0.0, meanMs = 0.0, p99Ms = 0.0, maxMs = 0.0;
+        double meanLoad = 0.0, p99Load = 0.0, maxLoad = 0.0; // fractions of the period
+    };
+
+    // Audio thread.
+    void record(double elapsedSeconds, double periodSeconds) {
+        // A plain load keeps the common case free of a locked RMW.
+        if (resetRequested.load(std::memory_order_acquire)
+            && resetRequested.exchange(false, std::memory_order_acquire)) clear();
+        const double load = periodSeconds > 0.0 ? elapsedSeconds / periodSeconds : 0.0;
+        const double us = elapsedSeconds * 1.0e6;
+        bump(loadHistogram[(size_t)std::clamp((int)(load * 100.0), 0, LOAD_BUCKETS - 1)]);
+        bump(timeHistogram[(size_t)std::clamp((int)(std::log2(std::max(us, 1.0)) * TIME_BUCKETS_PER_OCTAVE), 0, TIME_BUCKETS - 1)]);
+        if (load > 1.0) bump(overruns);
+        add(totalMicros, us);
+        add(totalLoad, load);
+        if (us < minMicros.load(std::memory_order_relaxed)) minMicros.store(us, std::memory_order_relaxed);
+        if (us > maxMicros.load(std::memory_order_relaxed)) maxMicros.store(us, std::memory_order_relaxed);
+        if (load > maxLoad.load(std::memory_order_relaxed)) maxLoad.store(load, std::memory_order_relaxed);
+        bump(callbacks);
+    }
+    void notePhysicsUpdate() { bump(physicsUpdates); }
+
+    // Any thread. The audio thread clears at its next record().
+    void requestReset() { resetRequested.store(true, std::memory_order_release); }
+
+    Snapshot snapshot() const {
+        Snapshot out;
+        out.callbacks = callbacks.load(std::memory_order_relaxed);
+        out.overruns = overruns.load(std::memory_order_relaxed);
+        out.physicsUpdates = physicsUpdates.load(std::memory_order_relaxed);
+        if (out.callbacks == 0) return out;
+        const double n = (double)out.callbacks;
+        out.minMs = minMicros.load(std::memory_order_relaxed) * 1.0e-3;
+        out.maxMs = maxMicros.load(std::memory_order_relaxed) * 1.0e-3;
+        out.meanMs = totalMicros.load(std::memory_order_relaxed) / n * 1.0e-3;
+        out.meanLoad = totalLoad.load(std::memory_order_relaxed) / n;
+        out.maxLoad = maxLoad.load(std::memory_order_relaxed);
+        // Upper edge of the bucket holding the 99th percentile.
+        const int loadBucket = percentileBucket(loadHistogram, 0.99);
+        out.p99Load = (loadBucket + 1) * 0.01;
+        const int timeBucket = percentileBucket(timeHistogram, 0.99);
+        out.p99Ms = std::exp2((double)(timeBucket + 1) / TIME_BUCKETS_PER_OCTAVE) * 1.0e-3;
+        return out;
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& c) { c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+    static void add(std::atomic<double>& a, double v) { a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed); }
+
+    template <size_t N>
+    static int percentileBucket(const std::array<std::atomic<uint64_t>, N>& histogram, double fraction) {
+        uint64_t total = 0;
+        for (const auto& b : histogram) total += b.load(std::memory_order_relaxed);
+        const double target = fraction * (double)total;
+        uint64_t running = 0;
+        for (size_t i = 0; i < N; ++i) {
+            running += histogram[i].load(std::memory_order_relaxed);
+            if ((double)running >= target) return (int)i;
+        }
+        return (int)N - 1;
+    }
+
+    void clear() {
+        for (auto& b : loadHistogram) b.store(0, std::memory_order_relaxed);
+        for (auto& b : timeHistogram) b.store(0, std::memory_order_relaxed);
+        for (auto* c : { &callbacks, &overruns, &physicsUpdates }) c->store(0, std::memory_order_relaxed);
+        totalMicros.store(0.0, std::memory_order_relaxed);
+        totalLoad.store(0.0, std::memory_order_relaxed);
+        minMicros.store(std::numeric_limits<double>::max(), std::memory_order_relaxed);
+        maxMicros.store(0.0, std::memory_order_relaxed);
+        maxLoad.store(0.0, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, LOAD_BUCKETS> loadHistogram{};
+    std::array<std::atomic<uint64_t>, TIME_BUCKETS> timeHistogram{};
+    std::atomic<uint64_t> callbacks{ 0 };
+    std::atomic<uint64_t> overruns{ 0 };
+    std::atomic<uint64_t> physicsUpdates{ 0 };
+    std::atomic<double> totalMicros{ 0.0 };
+    std::atomic<double> totalLoad{ 0.0 };
+    std::atomic<double> minMicros{ std::numeric_limits<double>::max() };
+    std::atomic<double> maxMicros{ 0.0 };
+    std::atomic<double> maxLoad{ 0.0 };
+    std::atomic<bool> resetRequested{ false };
+};
+
+// The arguments of FDNEngine::updatePhysics() in engine units (metres,
+// ms, Hz), plus the velvet length and ER order it otherwise takes through
+// setters. Defaults match the default preset.
+struct PhysicsParams {
+    static constexpr int NUM_FIELDS = 36;
+
+    float width = 10.0f, depth = 10.0f, height = 5.0f;
+    int matFloor = 0, matCeil = 0, matWallSide = 0, matWallFB = 0;
+    float absorption = 0.5f;
+    float modRate = 0.5f, modDepth = 0.2f, predelayMs = 0.0f;
+    float tempC = 20.0f, humidityPct = 50.0f, dryWet = 0.3f;
+    float inLC = 20.0f, inHC = 20000.0f, outLC = 20.0f, outHC = 20000.0f;
+    float sourceDist = 5.0f, sourcePan = 0.0f, sourceHeight = 2.5f;
+    int roomShape = 0;
+    float diffusion = 0.8f, stereoWidth = 1.0f, outputLevel = 1.0f, density = 0.0f, drive = 0.0f;
+    float dynamics = 0.0f, tilt = 0.0f;
+    float dynThreshold = -20.0f, dynRatio = 2.0f, dynAttack = 10.0f, dynRelease = 100.0f;
+    float decay = 1.0f;
+    int diffusionLength = 0; // index into VelvetDiffuser::LENGTHS_MS
+    int erOrder = MIN_ER_ORDER;
+
+    // Every field, for caching by value.
+    std::array<float, NUM_FIELDS> key() const {
+        return { width, depth, height, (float)matFloor, (float)matCeil, (float)matWallSide, (float)matWallFB,
+            absorption, modRate, modDepth, predelayMs, tempC, humidityPct, dryWet,
+            inLC, inHC, outLC, outHC, sourceDist, sourcePan, sourceHeight, (float)roomShape,
+            diffusion, stereoWidth, outputLevel, density, drive, dynamics, tilt,
+            dynThreshold, dynRatio, dynAttack, dynRelease, decay, (float)diffusionLength, (float)erOrder };
+    }
+};
+
 class FDNEngine {
 public:
-    FDNEngine() {
+    FDNEngine() : airTable(AirAbsorptionTable::shared()) {
         stereoSpreadBuffer.resize(2048, 0.0f);
         reset();
     }
+    ~FDNEngine() { stopPipelineWorker(); }
 
     void prepare(double sampleRate) {
+        waitForInputStage();
         fs = sampleRate;
-        int inDelaySize = (int)(static_cast<double>(MAX_DELAY_SECONDS) * sampleRate) + 4096;
-        if (inputDelayBuffer.size() < inDelaySize) {
-            inputDelayBuffer.resize(inDelaySize, 0.0f);
-        }
         stereoSpreadSamples = std::max(1, (int)(STEREO_SPREAD_MS * 0.001f * sampleRate));
         if (stereoSpreadSamples > 2048) stereoSpreadSamples = 2048;
         for (int i = 0; i < FDN_CHANNELS; ++i) {
-            channels[i].lfo.setFrequency(0.5f * LFO_RATIOS[i], (float)fs);
-            channels[i].lfo.setPhase((float)i / (float)FDN_CHANNELS);
+            lineLFOs.setFrequency(i, 0.5f * LFO_RATIOS[i], (float)fs);
+            lineLFOs.setPhase(i, (float)i / (float)FDN_CHANNELS);
             channels[i].prepare(sampleRate);
         }
-        inFilterL.prepare((float)fs); inFilterR.prepare((float)fs);
-        outFilterL.prepare((float)fs); outFilterR.prepare((float)fs);
-        velvetL.prepare((float)fs); velvetR.prepare((float)fs);
+        inFilter.prepare((float)fs);
+        outFilter.prepare((float)fs);
+        velvet.prepare((float)fs);
         sideHPF.setFrequency(200.0f, (float)fs);
         sideHPF.reset();
         erEngine.prepare(sampleRate);
         dynamicsProcessor.prepare((float)sampleRate);
-        tiltEQ_L.prepare((float)sampleRate);
-        tiltEQ_R.prepare((float)sampleRate);
+        tiltEQ.prepare((float)sampleRate);
         reset();
     }
 
     void reset() {
+        waitForInputStage();
         for (int i = 0; i < FDN_CHANNELS; ++i) {
             channels[i].reset();
-            channels[i].lfo.setPhase((float)i / (float)FDN_CHANNELS);
+            lineLFOs.setPhase(i, (float)i / (float)FDN_CHANNELS);
         }
-        std::fill(inputDelayBuffer.begin(), inputDelayBuffer.end(), 0.0f);
-        inputDelayWritePos = 0;
         std::fill(stereoSpreadBuffer.begin(), stereoSpreadBuffer.end(), 0.0f);
         stereoSpreadWritePos = 0;
         dryGainSmoother.snapTo(1.0f);
         wetGainSmoother.snapTo(0.0f);
+        wetFadeSmoother.snapTo(1.0f);
         erEngine.reset();
-        dcBlockerL.reset(); dcBlockerR.reset();
-        inFilterL.reset(); inFilterR.reset();
-        outFilterL.reset(); outFilterR.reset();
-        velvetL.reset(); velvetR.reset();
+        dcBlocker.reset();
+        inFilter.reset();
+        outFilter.reset();
+        velvet.reset();
         sideHPF.reset();
         dynamicsProcessor.reset();
-        tiltEQ_L.reset(); tiltEQ_R.reset();
+        tiltEQ.reset();
+        for (auto& s : driveADAA) s.reset();
+        if (pipelined) primePipeline();
     }
 
     void updatePhysics(float widthM, float depthM, float heightM,
@@ -858,6 +2755,7 @@ public:
         float dynThreshold, float dynRatio, float dynAttack, float dynRelease,
         int samplesPerBlock, float decayRatio) {
 
+        waitForInputStage();
         currentShapeMode = roomShape;
 
         // Check for SFX Materials (Priority: Floor > Ceil > Wall)
@@ -914,7 +2812,7 @@ public:
         for (float r : ratios) ratioSum += r;
 
         float targetDelays[16] = { 0.0f };
-        int maxChBuf = (int)channels[0].buffer.size();
+        int maxChBuf = channels[0].ringSize;
         for (int i = 0; i < FDN_CHANNELS; ++i) {
             float rawDelay = baseDelaySec * ratios[i] * (float)fs;
             int primeDelay = findNearestPrime((int)rawDelay);
@@ -925,10 +2823,8 @@ public:
         currentDrive = drive;
         dynamicsProcessor.setParams(dynThreshold, dynRatio, dynAttack, dynRelease);
         currentDynamicsAmount = dynamicsAmount;
-        tiltEQ_L.setTilt(tilt);
-        tiltEQ_R.setTilt(tilt);
-        velvetL.setAmount(diffusion);
-        velvetR.setAmount(diffusion);
+        tiltEQ.setTilt(tilt);
+        velvet.setAmount(diffusion);
 
         // SFX Mode Overrides
         if (sfxType > 0) {
@@ -974,7 +2870,7 @@ public:
 
                 targetDelays[i] = fixedDelay * (float)fs;
                 channels[i].materialFilter.setCoeffs(sfxGains, 1.0f, (float)fs);
-                channels[i].lfo.setFrequency(lfoFreq, (float)fs);
+                lineLFOs.setFrequency(i, lfoFreq, (float)fs);
                 currentModDepth = lfoDepthScaled;
             }
         }
@@ -1000,11 +2896,11 @@ public:
                 if (a < 0.01f) a = 0.01f;
                 avgAbs[b] = a;
             }
-            static const float freqs[6] = { 125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f };
             float exponent = (decayRatio > 0.01f) ? (1.0f / decayRatio) : 100.0f;
+            const AirAbsorptionTable::Bands airLog2 = airTable->lookup(tempC, humidityPct);
             std::array<float, 6> finalGains;
             for (int b = 0; b < 6; ++b) {
-                float air = std::pow(calcAirAbsorption(freqs[b], tempC, humidityPct), mfp);
+                float air = std::exp2(airLog2[b] * mfp);
                 float r = std::sqrt(1.0f - avgAbs[b]) * air;
                 r = std::pow(r, exponent);
                 if (r > 0.98f) r = 0.98f;
@@ -1031,7 +2927,7 @@ public:
                 }
                 channels[i].materialFilter.setCoeffs(sampleGains, baseGain, (float)fs);
                 float uniqueRate = rateScaled * LFO_RATIOS[i];
-                channels[i].lfo.setFrequency(uniqueRate, (float)fs);
+                lineLFOs.setFrequency(i, uniqueRate, (float)fs);
             }
 
             // Recalculate RT60 for graph
@@ -1057,9 +2953,6 @@ public:
         float distDelayReduction = distanceFactor * 20.0f;
         float effectivePreDelay = predelayMs - distDelayReduction;
         if (effectivePreDelay < 0.0f) effectivePreDelay = 0.0f;
-        currentPreDelaySamples = (int)((effectivePreDelay / 1000.0f) * fs);
-        int maxInBuf = (int)inputDelayBuffer.size();
-        if (currentPreDelaySamples >= maxInBuf) currentPreDelaySamples = maxInBuf - 1;
         float widthScaling = 1.0f - (distanceFactor * 0.5f);
         currentWidth = stereoWidth * widthScaling;
         float panVal = std::clamp(sourcePan, -1.0f, 1.0f);
@@ -1068,11 +2961,16 @@ public:
         float norm = 1.0f / std::sqrt(panInputL * panInputL + panInputR * panInputR);
         panInputL *= norm; panInputR *= norm;
         float safeSrcH = std::clamp(sourceHeight, 0.0f, heightM);
-        erEngine.updateGeometry(widthM, depthM, heightM, effectivePreDelay, safeSrcH, diffusion, sourceDist, sourcePan);
-        inFilterL.setHighPass(inLC); inFilterL.setLowPass(inHC);
-        inFilterR.setHighPass(inLC); inFilterR.setLowPass(inHC);
-        outFilterL.setHighPass(outLC); outFilterL.setLowPass(outHC);
-        outFilterR.setHighPass(outLC); outFilterR.setLowPass(outHC);
+        std::array<std::array<float, 6>, ER_NUM_SURFACES> surfaceAbs;
+        const int surfaceMats[ER_NUM_SURFACES] = { matFloorIdx, matCeilIdx, matWallIdx, matWallFBIdx };
+        for (int s = 0; s < ER_NUM_SURFACES; ++s) {
+            const MaterialDef& m = MaterialDB::get(surfaceMats[s]);
+            for (int b = 0; b < 6; ++b) surfaceAbs[s][b] = m.absorption[b] * (0.5f + absorptionOverride);
+        }
+        erEngine.setSurfaceAbsorption(surfaceAbs);
+        erEngine.updateGeometry(widthM, depthM, heightM, effectivePreDelay, safeSrcH, diffusion, sourceDist, sourcePan, roomShape);
+        inFilter.setHighPass(inLC); inFilter.setLowPass(inHC);
+        outFilter.setHighPass(outLC); outFilter.setLowPass(outHC);
 
         float baseGainMix = 1.0f / std::max(0.1f, (1.0f - absorptionOverride * 0.5f));
         float sizeComp = 1.0f + std::clamp(volume / 10000.0f, 0.0f, 0.5f);
@@ -1085,159 +2983,791 @@ public:
         dryGainSmoother.setTarget(dryG, smoothSamples);
         wetGainSmoother.setTarget(wetG, smoothSamples);
     }
+    void updatePhysics(const PhysicsParams& p, int samplesPerBlock) {
+        setEROrder(p.erOrder);
+        updatePhysics(p.width, p.depth, p.height, p.matFloor, p.matCeil, p.matWallSide, p.matWallFB,
+            p.absorption, p.modRate, p.modDepth, p.predelayMs, p.tempC, p.humidityPct, p.dryWet,
+            p.inLC, p.inHC, p.outLC, p.outHC, p.sourceDist, p.sourcePan, p.sourceHeight,
+            p.roomShape, p.diffusion, p.stereoWidth, p.outputLevel, p.density, p.drive, p.dynamics, p.tilt,
+            p.dynThreshold, p.dynRatio, p.dynAttack, p.dynRelease, samplesPerBlock, p.decay);
+        setDiffusionLength(p.diffusionLength);
+    }
 
     void process(float* const* inputChannelData, float* const* outputChannelData, int numSamples, int numChannels) {
+        ScopedFlushDenormals flushDenormals;
         const float* inL = inputChannelData[0];
         const float* inR = (numChannels > 1) ? inputChannelData[1] : inputChannelData[0];
         float* outL = outputChannelData[0];
         float* outR = (numChannels > 1) ? outputChannelData[1] : outputChannelData[0];
 
-        int inDelaySize = (int)inputDelayBuffer.size();
+        const bool useParallel = parallelProcessing && numSamples >= PARALLEL_MIN_BLOCK && lineGroupWorkers.running();
+        if (pipelined) {
+            processPipelined(inL, inR, outL, outR, numSamples, useParallel);
+#if FDN_PROFILE
+            profiler.addSamples(numSamples, fs);
+#endif
+            return;
+        }
+        for (int blockStart = 0; blockStart < numSamples; blockStart += PROCESS_BLOCK) {
+            const int blockLen = std::min(PROCESS_BLOCK, numSamples - blockStart);
+            runInputStage(inL + blockStart, inR + blockStart, blockLen,
+                diffusedL.data(), diffusedR.data(), erOut.data(), dynGains.data());
+            runRecursion(blockLen, useParallel);
+            runOutputStage(inL + blockStart, inR + blockStart, outL + blockStart, outR + blockStart, blockLen);
+        }
+#if FDN_PROFILE
+        profiler.addSamples(numSamples, fs);
+#endif
+    }
 
-        for (int n = 0; n < numSamples; ++n) {
-            float dryL = inL[n];
-            float dryR = inR[n];
+    // Audio thread only, like the other state it reads.
+    RT60Data getEstimatedRT60() const { return lastRT60Data; }
+    float getLoopEnergy() const {
+        float energy = 0.0f;
+        for (const auto& ch : channels) energy += ch.recentMeanSquare(LOOP_ENERGY_WINDOW);
+        return energy / (float)FDN_CHANNELS;
+    }
 
-            float inputMax = std::max(std::abs(dryL), std::abs(dryR));
-            float dynGain = dynamicsProcessor.process(inputMax, currentDynamicsAmount);
+    // Index into VelvetDiffuser::LENGTHS_MS.
+    void setDiffusionLength(int index) { waitForInputStage(); velvet.setLength(index); }
+    bool isDiffusionUsingFFT() const { return velvet.isUsingFFT(); }
+
+    // Image-source order for the early reflections; applied on the next updatePhysics().
+    void setEROrder(int order) { waitForInputStage(); erEngine.setOrder(order); }
+    void setSynchronousERSolve(bool shouldSolveInline) { waitForInputStage(); erEngine.setSynchronous(shouldSolveInline); }
+    int getNumERTaps() const { return erEngine.getNumTaps(); }
+
+    // Extra gain on the wet path alone (reverb and ERs, not the dry signal),
+    // ramped linearly over rampSamples from wherever it is now. For hiding
+    // switches that would click without touching the dry signal.
+    void fadeWet(float target, int rampSamples) { wetFadeSmoother.setTarget(target, rampSamples); }
+
+    // Multi-core mode. start/stop create and join the worker threads and are
+    // not realtime-safe; start may run on another thread while process()
+    // does, stop may not. setParallelProcessing only flips which path
+    // process() takes, and the parallel path is taken once the workers are
+    // up. Blocks shorter than PARALLEL_MIN_BLOCK always run on the calling
+    // thread.
+    bool startParallelWorkers(bool pinToCores = true) { return lineGroupWorkers.start(pinToCores); }
+    void stopParallelWorkers() { lineGroupWorkers.stop(); }
+    void setParallelProcessing(bool shouldRunParallel) { parallelProcessing = shouldRunParallel; }
+    bool isParallelAvailable() const { return lineGroupWorkers.running(); }
+
+    // Pipelined mode: the input stage runs on a worker thread one block
+    // ahead of the recursion, and the output is delayed by the latency
+    // passed to setPipelined (at most maxLatencySamples, normally the host
+    // block size at the DSP rate). start/stop allocate the rings and own
+    // the thread and are not realtime-safe; like the parallel workers, a
+    // first start may overlap process() but stop and restarts may not.
+    // setPipelined may be called from the audio thread and restarts the
+    // pipeline on any change.
+    bool startPipelineWorker(int maxLatencySamples) {
+        maxLatencySamples = std::max(1, maxLatencySamples);
+        if (pipelineWorker.running() && maxLatencySamples <= pipeMaxLatency) return true;
+        if (pipelineWorker.running()) stopPipelineWorker();
+        int capacity = PROCESS_BLOCK;
+        while (capacity < 2 * maxLatencySamples) capacity *= 2;
+        for (auto* ring : { &pipeInL, &pipeInR, &pipeDiffL, &pipeDiffR, &pipeGain }) ring->assign(capacity, 0.0f);
+        pipeEr.assign(2 * (size_t)capacity, 0.0f);
+        pipeMask = capacity - 1;
+        pipeMaxLatency = maxLatencySamples;
+        pipelineWorker.start(&FDNEngine::runPipelineJob, this);
+        pipelineAvailable.store(pipelineWorker.running(), std::memory_order_release);
+        return pipelineWorker.running();
+    }
+    void stopPipelineWorker() {
+        pipelineAvailable.store(false);
+        waitForInputStage();
+        pipelined = false;
+        pipelineWorker.stop();
+    }
+    bool isPipelineAvailable() const { return pipelineAvailable.load(std::memory_order_acquire); }
+    void setPipelined(bool shouldPipeline, int latencySamples) {
+        const bool available = isPipelineAvailable();
+        shouldPipeline = shouldPipeline && available;
+        latencySamples = std::clamp(latencySamples, 1, available ? std::max(1, pipeMaxLatency) : 1);
+        if (shouldPipeline == pipelined && (!shouldPipeline || latencySamples == pipeLatency)) return;
+        waitForInputStage();
+        pipelined = shouldPipeline;
+        pipeLatency = latencySamples;
+        if (pipelined) primePipeline();
+    }
+    // In samples at the engine rate; 0 when not pipelined.
+    int getPipelineLatency() const { return pipelined ? pipeLatency : 0; }
+
+    // Latest per-stage breakdown; never valid unless built with FDN_PROFILE.
+    // Call from one thread only.
+    StageProfiler::Breakdown getStageProfile() {
+#if FDN_PROFILE
+        return profiler.latest();
+#else
+        return {};
+#endif
+    }
 
-            float fltL = inFilterL.process(dryL);
-            float fltR = inFilterR.process(dryR);
+    // Opt-in anti-aliased drive (off by default). It runs inside the
+    // recursion, and in its linear region first-order ADAA is the average
+    // of the last two inputs: half a sample of delay and a Nyquist zero on
+    // every pass, which detunes the loop and piles up HF loss in the tail.
+    // Only worth it for heavily driven, short, bright settings.
+    void setDriveAntialiasing(bool shouldUseADAA) {
+        if (shouldUseADAA && !driveAntialiasing) for (auto& s : driveADAA) s.reset();
+        driveAntialiasing = shouldUseADAA;
+    }
 
-            float vlvL = velvetL.process(fltL);
-            float vlvR = velvetR.process(fltR);
+    FDNMemory::MemoryReport getMemoryReport() const {
+        FDNMemory::MemoryReport report;
+        for (const auto& ch : channels) report.add(ch.buffer);
+        report.add(erEngine.predelayBuffer);
+        return report;
+    }
+
+private:
+    ParameterSmoother dryGainSmoother;
+    ParameterSmoother wetGainSmoother;
+    ParameterSmoother wetFadeSmoother; // fadeWet()
+    std::vector<float> stereoSpreadBuffer;
+    int stereoSpreadSamples = 24;
+    int stereoSpreadWritePos = 0;
+    HighQualityFilter inFilter;
+    HighQualityFilter outFilter;
+    DynamicsProcessor dynamicsProcessor;
+    float currentDynamicsAmount = 0.0f;
+    TiltEqualizer tiltEQ;
+    VelvetDiffuser velvet;
+    std::array<SaturatorADAA, FDN_CHANNELS> driveADAA;
+    bool driveAntialiasing = false;
+    std::array<float, PROCESS_BLOCK> diffusedL{};
+    std::array<float, PROCESS_BLOCK> diffusedR{};
+    std::array<float, PROCESS_BLOCK> inputMono{};     // input stage scratch
+    std::array<float, 2 * PROCESS_BLOCK> inputLR{};   // input stage scratch, interleaved
+    std::array<float, PROCESS_BLOCK> dynGains{};
+    std::array<float, 2 * PROCESS_BLOCK> erOut{}; // interleaved L/R
+    std::array<float, 2 * PROCESS_BLOCK> ioLR{};  // interleaved L/R wet output
+    OnePoleHighpass sideHPF;
+    std::array<FDNChannel, FDN_CHANNELS> channels;
+    ChaosLFOBank lineLFOs;
+    static constexpr int LOOP_ENERGY_WINDOW = 64;
+    static constexpr int PARALLEL_MIN_BLOCK = 1024; // below this the barriers cost more than they save
+    static constexpr int MIN_PARALLEL_CHUNK = 64;
+    LineGroupWorkers lineGroupWorkers;
+    bool parallelProcessing = false;
+    int parBlockLen = 0;
+    int parChunkLen = 0;
+    int parNextChunkLen = 0;
+    alignas(64) float parLineOut[FDN_CHANNELS][PROCESS_BLOCK] = {};
+    alignas(64) float parLineIn[FDN_CHANNELS][PROCESS_BLOCK] = {};
+    EarlyReflections erEngine;
+    std::shared_ptr<const AirAbsorptionTable> airTable;
+    StereoDCBlocker dcBlocker;
+    double fs = 48000.0;
+    float currentModDepth = 0.0f;
+    float currentDrive = 0.0f;
+    float currentWidth = 1.0f;
+    float panInputL = 0.707f;
+    float panInputR = 0.707f;
+    float lastAvgDelay = 0.0f;
+    RT60Data lastRT60Data;
+    int currentShapeMode = 0;
 
-            float monoForER = (vlvL + vlvR) * 0.5f;
+    // Pipelined mode. Ring positions only ever grow: the audio thread
+    // publishes input up to pipeSubmitted, the worker publishes the input
+    // stage results up to pipeStaged, and the audio thread consumes them
+    // pipeLatency samples behind its input at pipeOutputPos.
+    bool pipelined = false;
+    int pipeLatency = 0;
+    int pipeMaxLatency = 0;
+    int pipeMask = 0;
+    std::vector<float> pipeInL, pipeInR;        // dry input
+    std::vector<float> pipeDiffL, pipeDiffR;    // diffused input
+    std::vector<float> pipeEr;                  // ER, interleaved L/R
+    std::vector<float> pipeGain;                // dynamics gain
+    std::atomic<uint64_t> pipeSubmitted{ 0 };
+    std::atomic<uint64_t> pipeStaged{ 0 };
+    std::atomic<bool> pipeStaging{ false };   // held for one input stage chunk, by either thread
+    std::atomic<bool> pipelineAvailable{ false }; // rings and worker ready
+    uint64_t pipeOutputPos = 0;
+#if FDN_PROFILE
+    StageProfiler profiler;
+#endif
+    PipelineWorker pipelineWorker;             // last: joined before the rings go away
+
+    // Feed-forward input stage. Runs on the worker when pipelined.
+    void runInputStage(const float* inL, const float* inR, int n,
+        float* outDiffL, float* outDiffR, float* outEr, float* outGains) {
+        FDN_PROFILE_START(profiler.input);
+        erEngine.pollSolver();
+        for (int k = 0; k < n; ++k) {
+            inputLR[2 * k] = inL[k];
+            inputLR[2 * k + 1] = inR[k];
+        }
+        inFilter.process(inputLR.data(), n);
+        for (int k = 0; k < n; ++k) {
+            outDiffL[k] = inputLR[2 * k];
+            outDiffR[k] = inputLR[2 * k + 1];
+        }
+        FDN_PROFILE_LAP(profiler.input, InputFilter);
+        dynamicsProcessor.process(inL, inR, outGains, n, currentDynamicsAmount);
+        FDN_PROFILE_LAP(profiler.input, Dynamics);
+        velvet.process(outDiffL, outDiffR, outDiffL, outDiffR, n);
+        FDN_PROFILE_LAP(profiler.input, Velvet);
+        for (int k = 0; k < n; ++k) inputMono[k] = (outDiffL[k] + outDiffR[k]) * 0.5f;
+        erEngine.process(inputMono.data(), outEr, n);
+        FDN_PROFILE_LAP(profiler.input, EarlyReflections);
+    }
 
-            inputDelayBuffer[inputDelayWritePos] = monoForER;
-            int readIdx = inputDelayWritePos - currentPreDelaySamples;
-            if (readIdx < 0) readIdx += inDelaySize;
-            float delayedERInput = inputDelayBuffer[readIdx];
-            inputDelayWritePos++;
-            if (inputDelayWritePos >= inDelaySize) inputDelayWritePos = 0;
+    // FDN recursion over diffusedL/R and erOut; leaves the wet signal in ioLR.
+    void runRecursion(int blockLen, bool useParallel) {
+        FDN_PROFILE_START(profiler.recursion);
+        const int firstChunk = useParallel ? parallelChunkBound() : 0;
+        if (firstChunk >= MIN_PARALLEL_CHUNK) {
+            parBlockLen = blockLen;
+            parChunkLen = std::min(blockLen, firstChunk);
+            lineGroupWorkers.run(&FDNEngine::runLineGroupJob, this);
+            FDN_PROFILE_LAP(profiler.recursion, LineGroups);
+            return;
+        }
+        for (int k = 0; k < blockLen; ++k) {
+            float delayOutputs[16];
+            float lineInputs[16];
+            readDelayLines(delayOutputs);
+            FDN_PROFILE_LAP(profiler.recursion, DelayRead);
+#pragma unroll
+            for (int i = 0; i < 16; ++i) delayOutputs[i] = channels[i].processMaterial(delayOutputs[i]);
+            FDN_PROFILE_LAP(profiler.recursion, MaterialFilter);
+#pragma unroll
+            for (int i = 0; i < 16; ++i) delayOutputs[i] = channels[i].processLoopAllpasses(delayOutputs[i]);
+            FDN_PROFILE_LAP(profiler.recursion, Allpass);
+            mixSample(k, delayOutputs, lineInputs);
+#pragma unroll
+            for (int i = 0; i < 16; ++i) channels[i].push(hardClip(lineInputs[i]));
+            FDN_PROFILE_LAP(profiler.recursion, Injection);
+        }
+    }
 
-            float erL = 0.0f, erR = 0.0f;
-            erEngine.process(delayedERInput, erL, erR);
+    // Feed-forward output stage, stereo-packed, then the dry/wet mix.
+    void runOutputStage(const float* dryL, const float* dryR, float* outL, float* outR, int blockLen) {
+        FDN_PROFILE_START(profiler.recursion);
+        dcBlocker.process(ioLR.data(), blockLen);
+        outFilter.process(ioLR.data(), blockLen);
+        for (int k = 0; k < 2 * blockLen; ++k) ioLR[k] += erOut[k];
+        tiltEQ.process(ioLR.data(), blockLen);
 
-            float delayOutputs[16] = { 0.0f };
-            float feedbackInputs[16] = { 0.0f };
+        for (int k = 0; k < blockLen; ++k) {
+            float dryG = dryGainSmoother.getNext();
+            float wetG = wetGainSmoother.getNext() * wetFadeSmoother.getNext();
+            float finalWetL = ioLR[2 * k] * dynGains[k];
+            float finalWetR = ioLR[2 * k + 1] * dynGains[k];
 
-#pragma unroll
-            for (int i = 0; i < 16; ++i) {
-                float raw = channels[i].read(currentModDepth);
-                delayOutputs[i] = channels[i].processFilter(raw);
-            }
+            float mixL = dryL[k] * dryG + finalWetL * wetG;
+            float mixR = dryR[k] * dryG + finalWetR * wetG;
 
-#pragma unroll
-            for (int i = 0; i < 16; ++i) feedbackInputs[i] = delayOutputs[i];
-
-            switch (currentShapeMode) {
-            case 0: matrixHadamard(feedbackInputs); break;
-            case 1: matrixHouseholder(feedbackInputs); break;
-            case 2: matrixBlockPerm(feedbackInputs); break;
-            case 3: matrixCylinder(feedbackInputs); break;
-            case 4: matrixSparse(feedbackInputs); break;
-            case 5: matrixMDS(feedbackInputs); break;
-            case 6: matrixChaos(feedbackInputs); break;
-            default: matrixHadamard(feedbackInputs); break;
+            outL[k] = std::clamp(mixL, -2.0f, 2.0f);
+            outR[k] = std::clamp(mixR, -2.0f, 2.0f);
+        }
+        FDN_PROFILE_LAP(profiler.recursion, OutputChain);
+    }
+
+    void processPipelined(const float* inL, const float* inR, float* outL, float* outR, int numSamples, bool useParallel) {
+        // Blocks longer than the latency are taken a latency-sized slice at
+        // a time; each slice then waits for the worker instead of overlapping.
+        for (int offset = 0; offset < numSamples;) {
+            const int slice = std::min(pipeLatency, numSamples - offset);
+            const uint64_t submitted = pipeSubmitted.load(std::memory_order_relaxed);
+            for (int k = 0; k < slice; ++k) {
+                const size_t idx = (size_t)((submitted + (uint64_t)k) & (uint64_t)pipeMask);
+                pipeInL[idx] = inL[offset + k];
+                pipeInR[idx] = inR[offset + k];
+            }
+            pipeSubmitted.store(submitted + (uint64_t)slice, std::memory_order_release);
+            pipelineWorker.notify();
+
+            for (int done = 0; done < slice;) {
+                const int idx = (int)(pipeOutputPos & (uint64_t)pipeMask);
+                const int len = std::min({ PROCESS_BLOCK, slice - done, pipeMask + 1 - idx });
+                waitForStaged(pipeOutputPos + (uint64_t)len);
+                std::memcpy(diffusedL.data(), &pipeDiffL[idx], sizeof(float) * (size_t)len);
+                std::memcpy(diffusedR.data(), &pipeDiffR[idx], sizeof(float) * (size_t)len);
+                std::memcpy(erOut.data(), &pipeEr[2 * (size_t)idx], sizeof(float) * 2 * (size_t)len);
+                std::memcpy(dynGains.data(), &pipeGain[idx], sizeof(float) * (size_t)len);
+                runRecursion(len, useParallel);
+                runOutputStage(&pipeInL[idx], &pipeInR[idx], outL + offset + done, outR + offset + done, len);
+                pipeOutputPos += (uint64_t)len;
+                done += len;
             }
+            offset += slice;
+        }
+    }
 
-#pragma unroll
-            for (int i = 0; i < 16; ++i) {
-                float injS = 0.0f;
-                if (i < 8) injS = vlvL * panInputL + vlvR * (1.0f - panInputL) * 0.5f;
-                else       injS = vlvR * panInputR + vlvL * (1.0f - panInputR) * 0.5f;
-
-                float wetIn = (i < 8) ? erL : erR;
-                float injected = injS + wetIn * 0.5f;
-
-                float sum = injected + feedbackInputs[i];
-                if (currentDrive > 0.001f) sum = softSaturate(sum, currentDrive * 0.5f);
-                sum = hardClip(sum);
-                channels[i].push(sum);
+    // Worker side: run the input stage over everything submitted so far.
+    static void runPipelineJob(void* context) { static_cast<FDNEngine*>(context)->drainInputStage(); }
+    // Either thread: stages one chunk at a time under pipeStaging. Returns
+    // false if the other thread holds the current chunk.
+    bool drainInputStage() {
+        for (;;) {
+            if (pipeStaging.exchange(true, std::memory_order_acquire)) return false;
+            const uint64_t pos = pipeStaged.load(std::memory_order_relaxed);
+            const uint64_t end = pipeSubmitted.load(std::memory_order_acquire);
+            if (pos < end) {
+                const int idx = (int)(pos & (uint64_t)pipeMask);
+                const int len = (int)std::min<uint64_t>({ (uint64_t)PROCESS_BLOCK, end - pos, (uint64_t)(pipeMask + 1 - idx) });
+                runInputStage(&pipeInL[idx], &pipeInR[idx], len, &pipeDiffL[idx], &pipeDiffR[idx], &pipeEr[2 * (size_t)idx], &pipeGain[idx]);
+                pipeStaged.store(pos + (uint64_t)len, std::memory_order_release);
             }
+            pipeStaging.store(false, std::memory_order_release);
+            if (pos >= end) return true;
+        }
+    }
+
+    // If the worker has not got there after a short spin, the audio thread
+    // stages the rest itself, so the wait is never longer than the worker's
+    // current chunk.
+    void waitForStaged(uint64_t pos) {
+        for (int spins = 0; pipeStaged.load(std::memory_order_acquire) < pos; ++spins) {
+            if (spins < 64) cpuRelax();
+            else if (!drainInputStage()) cpuRelax();
+        }
+    }
+    // Anything that touches the input stage's state from the audio thread
+    // calls this first. A no-op unless the worker is still busy.
+    void waitForInputStage() { waitForStaged(pipeSubmitted.load(std::memory_order_relaxed)); }
+
+    // Restart the pipeline with pipeLatency samples of silence in flight.
+    void primePipeline() {
+        const uint64_t submitted = pipeSubmitted.load(std::memory_order_relaxed);
+        for (int k = 0; k < pipeLatency; ++k) {
+            const size_t idx = (size_t)((submitted + (uint64_t)k) & (uint64_t)pipeMask);
+            pipeInL[idx] = 0.0f;
+            pipeInR[idx] = 0.0f;
+        }
+        pipeOutputPos = submitted;
+        pipeSubmitted.store(submitted + (uint64_t)pipeLatency, std::memory_order_release);
+        pipelineWorker.notify();
+    }
+
+    // Modulated Lagrange read of all 16 lines for one sample.
+    void readDelayLines(float* out) {
+        for (int first = 0; first < FDN_CHANNELS; first += 4) readLineGroup(first, 0, out + first);
+    }
+
+    // Lines first..first+3, read 'ahead' samples past their last push.
+    void readLineGroup(int first, int ahead, float* out) {
+        alignas(16) float lfoVals[4] = {};
+        if (currentModDepth > 0.001f) lineLFOs.processGroup(first, lfoVals);
+        alignas(16) float delays[4];
+        for (int j = 0; j < 4; ++j) {
+            float d = channels[first + j].delaySmoother.getNext() + lfoVals[j] * currentModDepth;
+            delays[j] = (d < 2.0f) ? 2.0f : d;
+        }
+#if FDN_HAS_SSE2
+        alignas(16) float readPos[4];
+        {
+            const FDNChannel* ch = &channels[first];
+            const __m128i sizeI = _mm_setr_epi32(ch[0].ringSize, ch[1].ringSize, ch[2].ringSize, ch[3].ringSize);
+            const __m128 sizeF = _mm_cvtepi32_ps(sizeI);
+            const __m128 writeF = _mm_cvtepi32_ps(_mm_setr_epi32(ch[0].writePosAhead(ahead), ch[1].writePosAhead(ahead),
+                ch[2].writePosAhead(ahead), ch[3].writePosAhead(ahead)));
+            __m128 r = _mm_sub_ps(writeF, _mm_load_ps(delays));
+            r = _mm_add_ps(r, _mm_and_ps(_mm_cmplt_ps(r, _mm_setzero_ps()), sizeF));
+            r = _mm_sub_ps(r, _mm_and_ps(_mm_cmpge_ps(r, sizeF), sizeF));
+            _mm_store_ps(readPos, r);
+            const __m128i i0 = _mm_cvttps_epi32(r);
+            const __m128 frac = _mm_sub_ps(r, _mm_cvtepi32_ps(i0));
+            __m128i base = _mm_sub_epi32(i0, _mm_set1_epi32(1));
+            base = _mm_add_epi32(base, _mm_and_si128(_mm_cmplt_epi32(base, _mm_setzero_si128()), sizeI));
+            alignas(16) int32_t idx[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(idx), base);
+
+            // Rows are (ym1, y0, y1, y2) per line; transpose to one tap per register.
+            __m128 ym1 = _mm_loadu_ps(ch[0].buffer.data() + idx[0]);
+            __m128 y0 = _mm_loadu_ps(ch[1].buffer.data() + idx[1]);
+            __m128 y1 = _mm_loadu_ps(ch[2].buffer.data() + idx[2]);
+            __m128 y2 = _mm_loadu_ps(ch[3].buffer.data() + idx[3]);
+            _MM_TRANSPOSE4_PS(ym1, y0, y1, y2);
+
+            const __m128 third = _mm_set1_ps(1.0f / 3.0f), half = _mm_set1_ps(0.5f), sixth = _mm_set1_ps(1.0f / 6.0f);
+            const __m128 c1 = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(y1, _mm_mul_ps(ym1, third)), _mm_mul_ps(y0, half)), _mm_mul_ps(y2, sixth));
+            const __m128 c2 = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(ym1, y1), half), y0);
+            const __m128 c3 = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(y0, y1), half), _mm_mul_ps(_mm_sub_ps(y2, ym1), sixth));
+            __m128 v = _mm_add_ps(_mm_mul_ps(c3, frac), c2);
+            v = _mm_add_ps(_mm_mul_ps(v, frac), c1);
+            v = _mm_add_ps(_mm_mul_ps(v, frac), y0);
+            _mm_storeu_ps(out, v);
+        }
+        for (int j = 0; j < 4; ++j)
+            if (channels[first + j].needsEpochRead(delays[j], ahead)) out[j] = channels[first + j].readEpoch(readPos[j], ahead);
+#else
+        for (int j = 0; j < 4; ++j) out[j] = channels[first + j].read(delays[j], ahead);
+#endif
+    }
 
-            float sumL = 0.0f, sumR = 0.0f;
+    // Feedback matrix, injection, drive and output tap for sub-block sample k.
+    // Leaves the (unclipped) next line inputs in lineInputs. The line groups
+    // call it with lap = false: their timeline also holds the barrier waits,
+    // which all belong to the LineGroups lap.
+    inline void mixSample(int k, const float* delayOutputs, float* lineInputs, bool lap = true) {
+        float vlvL = diffusedL[k];
+        float vlvR = diffusedR[k];
+
+        float erL = erOut[2 * k];
+        float erR = erOut[2 * k + 1];
+
+        float feedbackInputs[16];
 #pragma unroll
-            for (int i = 0; i < 8; ++i) sumL += delayOutputs[i];
+        for (int i = 0; i < 16; ++i) feedbackInputs[i] = delayOutputs[i];
+
+        switch (currentShapeMode) {
+        case 0: matrixHadamard(feedbackInputs); break;
+        case 1: matrixHouseholder(feedbackInputs); break;
+        case 2: matrixBlockPerm(feedbackInputs); break;
+        case 3: matrixCylinder(feedbackInputs); break;
+        case 4: matrixSparse(feedbackInputs); break;
+        case 5: matrixMDS(feedbackInputs); break;
+        case 6: matrixChaos(feedbackInputs); break;
+        default: matrixHadamard(feedbackInputs); break;
+        }
+        if (lap) FDN_PROFILE_LAP(profiler.recursion, Matrix);
+
 #pragma unroll
-            for (int i = 8; i < 16; ++i) sumR += delayOutputs[i];
+        for (int i = 0; i < 16; ++i) {
+            float injS = 0.0f;
+            if (i < 8) injS = vlvL * panInputL + vlvR * (1.0f - panInputL) * 0.5f;
+            else       injS = vlvR * panInputR + vlvL * (1.0f - panInputR) * 0.5f;
 
-            sumL *= 0.25f; sumR *= 0.25f;
+            float wetIn = (i < 8) ? erL : erR;
+            float injected = injS + wetIn * 0.5f;
 
-            stereoSpreadBuffer[stereoSpreadWritePos] = sumR;
-            int spreadIdx = stereoSpreadWritePos - stereoSpreadSamples;
-            if (spreadIdx < 0) spreadIdx += 2048;
-            spreadIdx &= 2047;
-            float delayedR = stereoSpreadBuffer[spreadIdx];
-            stereoSpreadWritePos = (stereoSpreadWritePos + 1) & 2047;
+            lineInputs[i] = injected + feedbackInputs[i];
+        }
+        if (currentDrive > 0.001f) {
+            const float lineDrive = currentDrive * 0.5f;
+            if (driveAntialiasing) {
+                for (int i = 0; i < 16; ++i) lineInputs[i] = driveADAA[i].process(lineInputs[i], lineDrive);
+            }
+            else {
+                softSaturateLines(lineInputs, 16, lineDrive);
+            }
+        }
+        if (lap) FDN_PROFILE_LAP(profiler.recursion, Injection);
 
-            float w = currentWidth;
-            float mid = (sumL + delayedR) * 0.5f;
-            float side = (sumL - delayedR) * 0.5f * w;
-            if (w > 1.2f) side = sideHPF.process(side);
+        float sumL = 0.0f, sumR = 0.0f;
+#pragma unroll
+        for (int i = 0; i < 8; ++i) sumL += delayOutputs[i];
+#pragma unroll
+        for (int i = 8; i < 16; ++i) sumR += delayOutputs[i];
 
-            float wetL = mid + side;
-            float wetR = mid - side;
+        sumL *= 0.25f; sumR *= 0.25f;
 
-            wetL = dcBlockerL.process(wetL);
-            wetR = dcBlockerR.process(wetR);
-            wetL = outFilterL.process(wetL);
-            wetR = outFilterR.process(wetR);
+        stereoSpreadBuffer[stereoSpreadWritePos] = sumR;
+        int spreadIdx = stereoSpreadWritePos - stereoSpreadSamples;
+        if (spreadIdx < 0) spreadIdx += 2048;
+        spreadIdx &= 2047;
+        float delayedR = stereoSpreadBuffer[spreadIdx];
+        stereoSpreadWritePos = (stereoSpreadWritePos + 1) & 2047;
 
-            float dryG = dryGainSmoother.getNext();
-            float wetG = wetGainSmoother.getNext();
-            float finalWetL = wetL + erL;
-            float finalWetR = wetR + erR;
+        float w = currentWidth;
+        float mid = (sumL + delayedR) * 0.5f;
+        float side = (sumL - delayedR) * 0.5f * w;
+        if (w > 1.2f) side = sideHPF.process(side);
 
-            finalWetL = tiltEQ_L.process(finalWetL);
-            finalWetR = tiltEQ_R.process(finalWetR);
+        ioLR[2 * k] = mid + side;
+        ioLR[2 * k + 1] = mid - side;
+        if (lap) FDN_PROFILE_LAP(profiler.recursion, OutputChain);
+    }
 
-            finalWetL *= dynGain;
-            finalWetR *= dynGain;
+    // Longest chunk every line can read without touching a sample the same
+    // chunk will write: the newest Lagrange tap sits 2 samples after the
+    // read position, so 'ahead' must stay below the shortest delay - 3.
+    int parallelChunkBound() const {
+        float shortest = std::numeric_limits<float>::max();
+        for (const auto& ch : channels)
+            shortest = std::min(shortest, std::min(ch.delaySmoother.getCurrent(), ch.delaySmoother.getTarget()));
+        shortest -= std::max(0.0f, currentModDepth) + 1.0f;
+        return std::max(1, (int)shortest - 3);
+    }
 
-            float mixL = inL[n] * dryG + finalWetL * wetG;
-            float mixR = inR[n] * dryG + finalWetR * wetG;
+    static void runLineGroupJob(void* context, int group) {
+        static_cast<FDNEngine*>(context)->runLineGroup(group);
+    }
 
-            outL[n] = std::clamp(mixL, -2.0f, 2.0f);
-            outR[n] = std::clamp(mixR, -2.0f, 2.0f);
+    // Every group runs this once per sub-block. Per chunk: read + filter
+    // the group's lines (parallel), mix (group 0 only), push (parallel).
+    void runLineGroup(int group) {
+        const int first = group * 4;
+        int start = 0;
+        int len = parChunkLen;
+        for (;;) {
+            for (int k = 0; k < len; ++k) {
+                float raw[4];
+                readLineGroup(first, k, raw);
+                for (int j = 0; j < 4; ++j) parLineOut[first + j][start + k] = channels[first + j].processFilter(raw[j]);
+            }
+            lineGroupWorkers.sync();
+            if (group == 0) {
+                for (int k = start; k < start + len; ++k) {
+                    float delayOutputs[16];
+                    float lineInputs[16];
+                    for (int i = 0; i < 16; ++i) delayOutputs[i] = parLineOut[i][k];
+                    mixSample(k, delayOutputs, lineInputs, false);
+                    for (int i = 0; i < 16; ++i) parLineIn[i][k] = lineInputs[i];
+                }
+                const int remaining = parBlockLen - (start + len);
+                parNextChunkLen = (remaining > 0) ? std::min(remaining, parallelChunkBound()) : 0;
+            }
+            lineGroupWorkers.sync();
+            for (int k = start; k < start + len; ++k)
+                for (int j = 0; j < 4; ++j) channels[first + j].push(hardClip(parLineIn[first + j][k]));
+            const int next = parNextChunkLen;
+            if (next == 0) break;
+            start += len;
+            len = next;
         }
     }
-
-    RT60Data getEstimatedRT60() const { return lastRT60Data; }
-
-private:
-    std::vector<float> inputDelayBuffer;
-    int inputDelayWritePos = 0;
-    int currentPreDelaySamples = 0;
-    ParameterSmoother dryGainSmoother;
-    ParameterSmoother wetGainSmoother;
-    std::vector<float> stereoSpreadBuffer;
-    int stereoSpreadSamples = 24;
-    int stereoSpreadWritePos = 0;
-    HighQualityFilter inFilterL, inFilterR;
-    HighQualityFilter outFilterL, outFilterR;
-    DynamicsProcessor dynamicsProcessor;
-    float currentDynamicsAmount = 0.0f;
-    TiltEqualizer tiltEQ_L, tiltEQ_R;
-    VelvetNoiseDiffuser velvetL, velvetR;
-    OnePoleHighpass sideHPF;
-    std::array<FDNChannel, FDN_CHANNELS> channels;
-    EarlyReflections erEngine;
-    DCBlocker dcBlockerL, dcBlockerR;
-    double fs = 48000.0;
-    float currentModDepth = 0.0f;
-    float currentDrive = 0.0f;
-    float currentWidth = 1.0f;
-    float panInputL = 0.707f;
-    float panInputR = 0.707f;
-    float lastAvgDelay = 0.0f;
-    RT60Data lastRT60Data;
-    int currentShapeMode = 0;
     float calcT60(float g) const {
         float safeG = std::min(g, 0.9995f);
         if (safeG <= 0.001f) return 0.0f;
         float delaySec = lastAvgDelay / (float)fs;
         return -3.0f * delaySec / std::log10(safeG);
     }
+};
+
+// ==============================================================================
+// 4. MEASURED DECAY
+// ==============================================================================
+
+// calcT60 is an estimate from the average delay and the loop gains; it
+// ignores modulation, the density allpasses and the matrix, and SFX mode
+// has none at all. This measures instead: it renders the impulse response
+// of a PhysicsParams snapshot on a private engine, splits it into the
+// AirAbsorptionTable octave bands and fits EDT / T20 / T30 to each band's
+// Schroeder curve. One worker at idle priority; a newer request aborts
+// the render in progress. start/stop allocate the engine and buffers
+// (about 40 MB) and join the thread, so they belong on the message
+// thread; request() is realtime-safe.
+class DecayAnalyzer {
+public:
+    static constexpr double SAMPLE_RATE = 48000.0;
+    static constexpr float MAX_SECONDS = 15.0f;
+    static constexpr float WARMUP_SECONDS = 0.1f;  // smoothers settle before the impulse
+    static constexpr float FLOOR_DB = -70.0f;      // rendering stops this far below the peak
+    static constexpr float IMPULSE = 0.1f;         // keeps the wet makeup gain clear of the output clamp
+    static constexpr int NUM_BANDS = AirAbsorptionTable::NUM_BANDS;
+
+    // Seconds per band; 0 where the curve did not fall far enough to fit.
+    struct Result {
+        std::array<float, NUM_BANDS> edt{};
+        std::array<float, NUM_BANDS> t20{};
+        std::array<float, NUM_BANDS> t30{};
+        uint32_t serial = 0; // 0 until something has been measured
+    };
+
+    DecayAnalyzer() = default;
+    ~DecayAnalyzer() { stop(); }
+    DecayAnalyzer(const DecayAnalyzer&) = delete;
+    DecayAnalyzer& operator=(const DecayAnalyzer&) = delete;
+
+    void start() {
+        if (worker.joinable()) return;
+        engine = std::make_unique<FDNEngine>();
+        engine->setSynchronousERSolve(true); // before prepare: no solver thread
+        engine->prepare(SAMPLE_RATE);
+        const size_t maxLength = (size_t)(MAX_SECONDS * SAMPLE_RATE);
+        response.assign(maxLength, 0.0f);
+        curve.assign(maxLength, 0.0);
+        quit.store(false);
+        worker = std::thread([this] { run(); });
+        active.store(true);
+    }
+    void stop() {
+        active.store(false);
+        if (!worker.joinable()) return;
+        quit.store(true);
+        wake.post();
+        worker.join();
+        engine.reset();
+        std::vector<float>().swap(response);
+        std::vector<double>().swap(curve);
+    }
+    bool running() const { return active.load(); }
+
+    // Audio thread: lock-free, and does nothing while stopped.
+    void request(const PhysicsParams& params) {
+        if (!active.load(std::memory_order_relaxed)) return;
+        requests.writeBuffer() = params;
+        requests.publish();
+        wake.post();
+    }
+
+    // One reader: true if a newer result is available through latest().
+    bool poll() { return results.update(); }
+    const Result& latest() const { return results.read(); }
+
+private:
+    static constexpr size_t MAX_CACHED = 32;
+    static constexpr int QUIET_BLOCKS = 8; // consecutive blocks under the floor before stopping
+    static constexpr float TAIL_WINDOW_SECONDS = 0.25f;
+
+    // The decay of the reverb itself: wet only at unity, no input shaping,
+    // dynamics or predelay.
+    static PhysicsParams normalized(PhysicsParams p) {
+        p.dryWet = 1.0f;
+        p.outputLevel = 1.0f;
+        p.predelayMs = 0.0f;
+        p.inLC = p.outLC = 20.0f;
+        p.inHC = p.outHC = 20000.0f;
+        p.dynamics = 0.0f;
+        p.tilt = 0.0f;
+        return p;
+    }
+
+    bool superseded() const { return quit.load() || requests.hasUpdate(); }
+
+    void run() {
+        setCurrentThreadPriority(ThreadPriority::Background);
+        ScopedFlushDenormals flushDenormals;
+        for (;;) {
+            wake.wait(); // as in ERSolverThread, one post per request
+            if (quit.load()) break;
+            if (!requests.update()) continue;
+            analyze(normalized(requests.read()));
+        }
+    }
+
+    void analyze(const PhysicsParams& params) {
+        const auto k = params.key();
+        auto it = cache.find(k);
+        if (it == cache.end()) {
+            Result measured;
+            if (!measure(params, measured)) return;
+            if (cache.size() >= MAX_CACHED) cache.clear();
+            it = cache.emplace(k, measured).first;
+        }
+        Result& r = results.writeBuffer();
+        r = it->second;
+        r.serial = ++serial;
+        results.publish();
+    }
+
+    // False if a newer request arrived first.
+    bool measure(const PhysicsParams& params, Result& out) {
+        engine->reset();
+        engine->updatePhysics(params, PROCESS_BLOCK);
+        float* ins[] = { blockIn[0].data(), blockIn[1].data() };
+        float* outs[] = { blockOut[0].data(), blockOut[1].data() };
+        for (auto& ch : blockIn) ch.fill(0.0f);
+        const int warmup = (int)(WARMUP_SECONDS * SAMPLE_RATE);
+        for (int done = 0; done < warmup; done += PROCESS_BLOCK)
+            engine->process(ins, outs, PROCESS_BLOCK, 2);
+
+        const int maxLength = (int)response.size();
+        int length = 0;
+        double peak = 0.0;
+        int quietBlocks = 0;
+        const double floor = std::pow(10.0, FLOOR_DB / 10.0);
+        while (length < maxLength && quietBlocks < QUIET_BLOCKS) {
+            if (superseded()) return false;
+            const int n = std::min(PROCESS_BLOCK, maxLength - length);
+            blockIn[0][0] = blockIn[1][0] = (length == 0) ? IMPULSE : 0.0f;
+            engine->process(ins, outs, n, 2);
+            double energy = 0.0;
+            for (int k = 0; k < n; ++k) {
+                const float v = 0.5f * (blockOut[0][k] + blockOut[1][k]);
+                response[(size_t)(length + k)] = v;
+                energy += (double)v * v;
+            }
+            length += n;
+            peak = std::max(peak, energy);
+            quietBlocks = (energy < peak * floor) ? quietBlocks + 1 : 0;
+        }
+
+        for (int b = 0; b < NUM_BANDS; ++b) {
+            if (superseded()) return false;
+            bandEnergy(AirAbsorptionTable::BAND_FREQS[b], length);
+            // Schroeder backward integration, normalised to 0 dB at t = 0.
+            double sum = tailEnergy(length);
+            for (int i = length - 1; i >= 0; --i) {
+                sum += curve[(size_t)i];
+                curve[(size_t)i] = sum;
+            }
+            if (sum <= 0.0) continue;
+            for (int i = 0; i < length; ++i) curve[(size_t)i] = 10.0 * std::log10(curve[(size_t)i] / sum + 1.0e-30);
+            // The tail estimate is only as good as the last window; fit
+            // above the level the curve has there, with some margin.
+            const int guard = std::max(0, length - (int)(TAIL_WINDOW_SECONDS * SAMPLE_RATE));
+            const double usableDb = curve[(size_t)guard] + 5.0;
+            out.edt[b] = fitDecay(length, 0.0, -10.0, usableDb);
+            out.t20[b] = fitDecay(length, -5.0, -25.0, usableDb);
+            out.t30[b] = fitDecay(length, -5.0, -35.0, usableDb);
+        }
+        return true;
+    }
+
+    // Octave band of the response, squared, into curve: two cascaded
+    // constant-peak bandpass sections (Q = sqrt(2), one octave).
+    void bandEnergy(float centre, int length) {
+        const double w0 = 2.0 * 3.14159265358979 * centre / SAMPLE_RATE;
+        const double alpha = std::sin(w0) / (2.0 * 1.41421356237);
+        const double a0 = 1.0 + alpha;
+        const double b0 = alpha / a0, b2 = -alpha / a0;
+        const double a1 = -2.0 * std::cos(w0) / a0, a2 = (1.0 - alpha) / a0;
+        double x1[2] = {}, x2[2] = {}, y1[2] = {}, y2[2] = {};
+        for (int i = 0; i < length; ++i) {
+            double v = response[(size_t)i];
+            for (int s = 0; s < 2; ++s) {
+                const double y = b0 * v + b2 * x2[s] - a1 * y1[s] - a2 * y2[s];
+                x2[s] = x1[s]; x1[s] = v;
+                y2[s] = y1[s]; y1[s] = y;
+                v = y;
+            }
+            curve[(size_t)i] = v * v;
+        }
+    }
+
+    // Energy past the end of the render, continuing the decay of the band
+    // energy in curve over the last two windows; 0 if it is not decaying.
+    double tailEnergy(int length) const {
+        const int window = (int)(TAIL_WINDOW_SECONDS * SAMPLE_RATE);
+        if (length < 2 * window) return 0.0;
+        double earlier = 0.0, later = 0.0;
+        for (int i = length - 2 * window; i < length - window; ++i) earlier += curve[(size_t)i];
+        for (int i = length - window; i < length; ++i) later += curve[(size_t)i];
+        if (later <= 0.0 || later >= earlier) return 0.0;
+        const double perSample = std::pow(later / earlier, 1.0 / window);
+        return (later / window) * perSample / (1.0 - perSample);
+    }
+
+    // Least-squares slope of the curve (in dB) between two levels,
+    // extrapolated to 60 dB.
+    float fitDecay(int length, double fromDb, double toDb, double usableDb) const {
+        if (toDb < usableDb) return 0.0f;
+        int first = 0;
+        while (first < length && curve[(size_t)first] > fromDb) ++first;
+        int last = first;
+        while (last < length && curve[(size_t)last] > toDb) ++last;
+        if (last >= length || last - first < 2) return 0.0f;
+        double st = 0.0, sy = 0.0, stt = 0.0, sty = 0.0;
+        const double n = (double)(last - first + 1);
+        for (int i = first; i <= last; ++i) {
+            const double t = (double)(i - first) / SAMPLE_RATE;
+            const double y = curve[(size_t)i];
+            st += t; sy += y; stt += t * t; sty += t * y;
+        }
+        const double slope = (n * sty - st * sy) / (n * stt - st * st);
+        return (slope < 0.0) ? (float)(-60.0 / slope) : 0.0f;
+    }
+
+    std::unique_ptr<FDNEngine> engine;
+    std::vector<float> response;  // mono impulse response
+    std::vector<double> curve;    // band energy, then its decay curve in dB
+    std::array<std::array<float, PROCESS_BLOCK>, 2> blockIn{};
+    std::array<std::array<float, PROCESS_BLOCK>, 2> blockOut{};
+
+    TripleBuffer<PhysicsParams> requests;
+    TripleBuffer<Result> results;
+    std::map<std::array<float, PhysicsParams::NUM_FIELDS>, Result> cache; // worker only
+    uint32_t serial = 0;
+    WakeSemaphore wake;
+    std::atomic<bool> quit{ false };
+    std::atomic<bool> active{ false };
+    std::thread worker;
 };
\ No newline at end of file
@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+    FDN_Engine.cpp
+    Phase 213: Engine Library
+  ==============================================================================
+*/
+#include "FDN_Engine.h"
+#include "FDN_DSP.h"
+
+namespace FDNReverb {
+
+namespace {
+
+// Exactly one of the two members is set.
+struct FieldInfo {
+    const char* name;
+    float Settings::* real;
+    int Settings::* index;
+};
+
+const FieldInfo FIELDS[] = {
+    { "width", &Settings::width, nullptr },
+    { "depth", &Settings::depth, nullptr },
+    { "height", &Settings::height, nullptr },
+    { "matFloor", nullptr, &Settings::matFloor },
+    { "matCeil", nullptr, &Settings::matCeil },
+    { "matWallSide", nullptr, &Settings::matWallSide },
+    { "matWallFB", nullptr, &Settings::matWallFB },
+    { "absorption", &Settings::absorption, nullptr },
+    { "modRate", &Settings::modRate, nullptr },
+    { "modDepth", &Settings::modDepth, nullptr },
+    { "predelay", &Settings::predelay, nullptr },
+    { "decay", &Settings::decay, nullptr },
+    { "temp", &Settings::temp, nullptr },
+    { "humidity", &Settings::humidity, nullptr },
+    { "inLC", &Settings::inLC, nullptr },
+    { "inHC", &Settings::inHC, nullptr },
+    { "outLC", &Settings::outLC, nullptr },
+    { "outHC", &Settings::outHC, nullptr },
+    { "dist", &Settings::dist, nullptr },
+    { "pan", &Settings::pan, nullptr },
+    { "sourceHeight", &Settings::sourceHeight, nullptr },
+    { "mix", &Settings::mix, nullptr },
+    { "roomShape", nullptr, &Settings::roomShape },
+    { "diffusion", &Settings::diffusion, nullptr },
+    { "stereoWidth", &Settings::stereoWidth, nullptr },
+    { "outputLevel", &Settings::outputLevel, nullptr },
+    { "drive", &Settings::drive, nullptr },
+    { "density", &Settings::density, nullptr },
+    { "dynamics", &Settings::dynamics, nullptr },
+    { "tilt", &Settings::tilt, nullptr },
+    { "dynThreshold", &Settings::dynThreshold, nullptr },
+    { "dynRatio", &Settings::dynRatio, nullptr },
+    { "dynAttack", &Settings::dynAttack, nullptr },
+    { "dynRelease", &Settings::dynRelease, nullptr },
+    { "diffLength", nullptr, &Settings::diffLength },
+    { "erOrder", nullptr, &Settings::erOrder },
+};
+static_assert(sizeof(FIELDS) / sizeof(FIELDS[0]) == (size_t)Param::Count, "one entry per Param");
+
+const FieldInfo& field(Param p) { return FIELDS[std::clamp((int)p, 0, (int)Param::Count - 1)]; }
+
+// Same conversions as FdnReverbAudioProcessor::processBlock.
+PhysicsParams toPhysics(const Settings& s) {
+    PhysicsParams p;
+    p.width = s.width; p.depth = s.depth; p.height = s.height;
+    p.matFloor = s.matFloor; p.matCeil = s.matCeil; p.matWallSide = s.matWallSide; p.matWallFB = s.matWallFB;
+    p.absorption = s.absorption;
+    p.modRate = s.modRate; p.modDepth = s.modDepth; p.predelayMs = s.predelay;
+    p.tempC = s.temp; p.humidityPct = s.humidity; p.dryWet = s.mix;
+    p.inLC = s.inLC; p.inHC = s.inHC; p.outLC = s.outLC; p.outHC = s.outHC;
+    p.sourceDist = std::max(0.5f, s.dist * s.depth);
+    p.sourcePan = s.pan;
+    p.sourceHeight = std::max(0.1f, s.sourceHeight * s.height);
+    p.roomShape = s.roomShape; p.diffusion = s.diffusion; p.stereoWidth = s.stereoWidth; p.outputLevel = s.outputLevel;
+    p.density = s.density; p.drive = s.drive; p.decay = s.decay;
+    p.dynamics = s.dynamics; p.tilt = s.tilt;
+    p.dynThreshold = s.dynThreshold; p.dynRatio = s.dynRatio; p.dynAttack = s.dynAttack; p.dynRelease = s.dynRelease;
+    p.diffusionLength = std::clamp(s.diffLength, 0, VelvetDiffuser::NUM_LENGTHS - 1);
+    p.erOrder = s.erOrder;
+    return p;
+}
+
+} // namespace
+
+const char* paramName(Param p) { return field(p).name; }
+
+bool findParam(const std::string& name, Param& out) {
+    for (int i = 0; i < (int)Param::Count; ++i) {
+        if (name == FIELDS[i].name) {
+            out = (Param)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+struct Engine::Impl {
+    FDNEngine engine;
+    Options options;
+    Settings settings;
+    bool dirty = true;
+};
+
+Engine::Engine() : Engine(Options{}) {}
+
+Engine::Engine(const Options& options) : impl(std::make_unique<Impl>()) {
+    static_assert(Settings{}.erOrder == MIN_ER_ORDER, "Settings defaults follow the engine");
+    prepare(options);
+}
+
+Engine::~Engine() = default;
+
+void Engine::prepare(const Options& options) {
+    Impl& d = *impl;
+    d.options = options;
+    d.options.blockSize = std::max(1, options.blockSize);
+    // Before prepare, so offline engines do not start the solver thread.
+    d.engine.setSynchronousERSolve(!options.realtime);
+    d.engine.prepare(options.sampleRate);
+    d.engine.setDriveAntialiasing(options.driveAntialiasing);
+    if (options.multiCore) d.engine.startParallelWorkers();
+    else d.engine.stopParallelWorkers();
+    d.engine.setParallelProcessing(d.engine.isParallelAvailable());
+    d.dirty = true;
+}
+
+const Engine::Options& Engine::getOptions() const { return impl->options; }
+
+void Engine::reset() {
+    impl->engine.reset();
+    impl->dirty = true;
+}
+
+void Engine::setSettings(const Settings& settings) {
+    impl->settings = settings;
+    impl->dirty = true;
+}
+
+const Settings& Engine::getSettings() const { return impl->settings; }
+
+void Engine::setParameter(Param p, float value) {
+    const FieldInfo& f = field(p);
+    if (f.real != nullptr) impl->settings.*f.real = value;
+    else impl->settings.*f.index = (int)std::lround(value);
+    impl->dirty = true;
+}
+
+float Engine::getParameter(Param p) const {
+    const FieldInfo& f = field(p);
+    return (f.real != nullptr) ? impl->settings.*f.real : (float)(impl->settings.*f.index);
+}
+
+void Engine::process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) {
+    Impl& d = *impl;
+    const bool stereo = inR != nullptr && outR != nullptr;
+    for (int offset = 0; offset < numSamples;) {
+        const int n = std::min(d.options.blockSize, numSamples - offset);
+        if (d.dirty) {
+            // The glide length, not this chunk's length: a short tail chunk
+            // must not make the delay jump.
+            d.engine.updatePhysics(toPhysics(d.settings), d.options.blockSize);
+            d.dirty = false;
+        }
+        // The engine only reads its inputs.
+        float* ins[] = { const_cast<float*>(inL + offset), const_cast<float*>(stereo ? inR + offset : inL + offset) };
+        float* outs[] = { outL + offset, stereo ? outR + offset : outL + offset };
+        d.engine.process(ins, outs, n, stereo ? 2 : 1);
+        offset += n;
+    }
+}
+
+void Engine::processBatch(const float* inL, const float* inR, float* outL, float* outR, int64_t numSamples,
+    const ParameterChange* changes, size_t numChanges) {
+    const bool stereo = inR != nullptr && outR != nullptr;
+    size_t next = 0;
+    for (int64_t pos = 0; pos < numSamples;) {
+        while (next < numChanges && changes[next].sampleOffset <= pos) {
+            setParameter(changes[next].param, changes[next].value);
+            ++next;
+        }
+        int64_t end = std::min(numSamples, pos + impl->options.blockSize);
+        if (next < numChanges) end = std::min(end, changes[next].sampleOffset);
+        process(inL + pos, stereo ? inR + pos : nullptr, outL + pos, stereo ? outR + pos : nullptr, (int)(end - pos));
+        pos = end;
+    }
+}
+
+} // namespace FDNReverb
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+    FDN_Engine.h
+    Phase 213: Engine Library
+
+    UPDATES:
+    - JUCE-free front end for FDNEngine, built as the fdn_engine static
+      library (see CMakeLists.txt) for headless rendering and benchmarks.
+    - Settings: the numeric part of ReverbPreset, in the same units.
+    - Partial updates by Param, applied together at the next block.
+    - processBatch(): any length, with sample-timed parameter changes.
+    - FDN_DSP.h stays private to the library; this header only needs the
+      standard library.
+  ==============================================================================
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace FDNReverb {
+
+// Everything a preset stores, with the preset's units and defaults.
+// ReverbPreset adds its name, category and description to this.
+struct Settings {
+    // Core Physics
+    float width = 10.0f;
+    float depth = 10.0f;
+    float height = 5.0f;
+    int matFloor = 0;
+    int matCeil = 0;
+    int matWallSide = 0;
+    int matWallFB = 0;
+    float absorption = 0.5f;
+
+    // Modulation & Time
+    float modRate = 0.5f;
+    float modDepth = 0.2f;
+    float predelay = 0.0f;
+    float decay = 1.0f;
+
+    // Environment
+    float temp = 20.0f;
+    float humidity = 50.0f;
+
+    // Filters
+    float inLC = 20.0f;
+    float inHC = 20000.0f;
+    float outLC = 20.0f;
+    float outHC = 20000.0f;
+
+    // Source & Mix (dist and sourceHeight are fractions of depth and height)
+    float dist = 0.5f;
+    float pan = 0.0f;
+    float sourceHeight = 0.5f;
+    float mix = 0.3f;
+
+    // Character
+    int roomShape = 0;
+    float diffusion = 0.8f;
+    float stereoWidth = 1.0f;
+    float outputLevel = 1.0f;
+    float drive = 0.0f;
+    float density = 0.0f;
+
+    // Advanced Features
+    float dynamics = 0.0f; // Amount
+    float tilt = 0.0f;
+
+    // Dynamics Details
+    float dynThreshold = -20.0f;
+    float dynRatio = 2.0f;
+    float dynAttack = 10.0f;
+    float dynRelease = 100.0f;
+
+    // Velvet pre-diffusion length (index into VelvetDiffuser::LENGTHS_MS)
+    int diffLength = 0;
+
+    // Image-source order of the early reflections (MIN_ER_ORDER..MAX_ER_ORDER)
+    int erOrder = 3;
+};
+
+// One per Settings field, in declaration order.
+enum class Param : int {
+    Width, Depth, Height, MatFloor, MatCeil, MatWallSide, MatWallFB, Absorption,
+    ModRate, ModDepth, Predelay, Decay, Temp, Humidity,
+    InLC, InHC, OutLC, OutHC, Dist, Pan, SourceHeight, Mix,
+    RoomShape, Diffusion, StereoWidth, OutputLevel, Drive, Density,
+    Dynamics, Tilt, DynThreshold, DynRatio, DynAttack, DynRelease,
+    DiffLength, EROrder,
+    Count
+};
+
+// The Settings field name ("width", "dynThreshold", ...).
+const char* paramName(Param p);
+// False if there is no such field.
+bool findParam(const std::string& name, Param& out);
+
+struct ParameterChange {
+    int64_t sampleOffset = 0; // from the start of the processBatch call
+    Param param = Param::Width;
+    float value = 0.0f;
+};
+
+class Engine {
+public:
+    struct Options {
+        double sampleRate = 48000.0;
+        int blockSize = 512;     // settings apply at block starts; also the delay glide length
+        bool realtime = false;   // false: ERs are solved inline, so renders are deterministic
+        bool multiCore = false;  // line groups on worker threads when there are enough cores
+        bool driveAntialiasing = false; // ADAA on the in-loop drive; see FDNEngine::setDriveAntialiasing
+    };
+
+    Engine();
+    explicit Engine(const Options& options);
+    ~Engine();
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    // Allocates and (with multiCore) starts threads; not realtime-safe.
+    // Settings are kept and reapplied.
+    void prepare(const Options& options);
+    const Options& getOptions() const;
+    // Clears the delay lines and filters.
+    void reset();
+
+    void setSettings(const Settings& settings);
+    const Settings& getSettings() const;
+    // Partial update; int fields are rounded. Changes made between two
+    // blocks are applied together.
+    void setParameter(Param p, float value);
+    float getParameter(Param p) const;
+
+    // Stereo, or mono with inR and outR both null. In place is fine.
+    void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+    // Any length. changes must be sorted by sampleOffset; each one takes
+    // effect at its sample.
+    void processBatch(const float* inL, const float* inR, float* outL, float* outR, int64_t numSamples,
+        const ParameterChange* changes = nullptr, size_t numChanges = 0);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace FDNReverb
@@ -0,0 +1,294 @@
+/*
+  ==============================================================================
+    FDN_FlightRecorder.h
+    Phase 210: Flight Recorder
+
+    UPDATES:
+    - Recorder: fixed-size SPSC ring of 24-byte timestamped events. The
+      audio thread pushes (never blocks, counts drops when full).
+    - LogWriter: background thread that drains the ring every 100 ms into
+      a compact binary log, rotating to "<name>.old" past MAX_LOG_BYTES.
+    - One LogWriter thread per process (LogWriter::shared()); opening a log
+      prunes its folder to the newest MAX_LOG_FILES.
+    - Tools/fdn_flight_decode.cpp turns a log into text.
+  ==============================================================================
+*/
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace FDNFlight {
+
+enum EventType : uint16_t {
+    CallbackOverrun = 1, // a = elapsed ms, b = period ms
+    PhysicsUpdate   = 2, // a = updatePhysics duration in us
+    ParamChange     = 3, // code = PhysicsState field, a = old, b = new
+    QualitySwitch   = 4, // code = auto quality tier, a = old factor, b = new factor
+    Panic           = 5,
+    Prepare         = 6, // a = sample rate, b = block size (host started processing)
+    Release         = 7, // host stopped processing
+    Dropped         = 8  // a = events lost to a full ring so far
+};
+
+struct Event {
+    uint64_t timeNs = 0; // steady clock
+    uint16_t type = 0;
+    uint16_t code = 0;
+    uint32_t reserved = 0;
+    float a = 0.0f;
+    float b = 0.0f;
+};
+static_assert(sizeof(Event) == 24, "log format depends on the event size");
+
+struct FileHeader {
+    char magic[8] = { 'F', 'D', 'N', 'F', 'L', 'T', '1', '\0' };
+    uint32_t version = 1;
+    uint32_t eventSize = (uint32_t)sizeof(Event);
+    int64_t wallClockNs = 0; // system clock (Unix epoch) when the file was opened
+    uint64_t steadyNs = 0;   // steady clock at the same moment
+};
+static_assert(sizeof(FileHeader) == 32, "log format depends on the header size");
+
+// PhysicsState fields in declaration order; ParamChange codes index this.
+static constexpr int NUM_PHYSICS_FIELDS = 37;
+inline const char* physicsFieldName(int index) {
+    static const char* names[NUM_PHYSICS_FIELDS] = {
+        "width", "depth", "height", "matFloor", "matCeil", "matWallSide", "matWallFB",
+        "absorption", "modRate", "modDepth", "predelay", "temp", "humidity", "mix",
+        "inLC", "inHC", "outLC", "outHC", "dist", "pan", "srcHeight", "shape",
+        "diffusion", "stereoWidth", "level", "density", "drive", "decay",
+        "dynamics", "tilt", "dynThresh", "dynRatio", "dynAttack", "dynRelease",
+        "diffLength", "erOrder", "blockSize"
+    };
+    return (index >= 0 && index < NUM_PHYSICS_FIELDS) ? names[index] : "?";
+}
+
+inline uint64_t nowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Single producer (audio thread), single consumer (LogWriter).
+class Recorder {
+public:
+    static constexpr size_t CAPACITY = 4096;
+
+    bool push(EventType type, uint16_t code = 0, float a = 0.0f, float b = 0.0f) noexcept {
+        if (!active.load(std::memory_order_relaxed)) return false;
+        const uint64_t w = writePos.load(std::memory_order_relaxed);
+        if (w - readPos.load(std::memory_order_acquire) >= CAPACITY) {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        Event& e = slots[(size_t)(w & (CAPACITY - 1))];
+        e.timeNs = nowNs();
+        e.type = (uint16_t)type;
+        e.code = code;
+        e.a = a;
+        e.b = b;
+        writePos.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.
+    size_t drain(std::vector<Event>& out) {
+        const uint64_t r = readPos.load(std::memory_order_relaxed);
+        const uint64_t w = writePos.load(std::memory_order_acquire);
+        for (uint64_t i = r; i < w; ++i) out.push_back(slots[(size_t)(i & (CAPACITY - 1))]);
+        readPos.store(w, std::memory_order_release);
+        return (size_t)(w - r);
+    }
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    // Pushes are ignored while inactive, so a recorder nobody drains does
+    // not fill up with stale events. Set by LogWriter.
+    void setActive(bool shouldRecord) { active.store(shouldRecord, std::memory_order_relaxed); }
+
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+    std::array<Event, CAPACITY> slots{};
+    std::atomic<uint64_t> writePos{ 0 };
+    std::atomic<uint64_t> readPos{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<bool> active{ false };
+};
+
+// Drains Recorders to files, one file per recorder, on one thread shared
+// by every instance in the process. A file is only created once its
+// recorder has something to write; creating one prunes the folder to the
+// newest MAX_LOG_FILES logs. The thread runs while any recorder is added.
+// Not realtime-safe; add/remove from the message thread.
+class LogWriter {
+public:
+    static constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(100);
+    static constexpr uint64_t MAX_LOG_BYTES = 8u * 1024u * 1024u;
+    static constexpr size_t MAX_LOG_FILES = 20; // per folder, ".old" rotations included
+
+    static LogWriter& shared() {
+        static LogWriter writer;
+        return writer;
+    }
+
+    LogWriter() = default;
+    ~LogWriter() { stopThread(); }
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator=(const LogWriter&) = delete;
+
+    // Starts recording source into path (UTF-8). Adding it again moves it.
+    void add(Recorder& source, const std::string& path) {
+        remove(source);
+        std::lock_guard<std::mutex> control(controlLock);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            Output out;
+            out.recorder = &source;
+            out.path = std::filesystem::u8path(path);
+            outputs.push_back(std::move(out));
+        }
+        source.setActive(true);
+        if (!thread.joinable()) {
+            stopping = false;
+            thread = std::thread([this] { run(); });
+        }
+    }
+    // Writes whatever source still has queued and closes its file. Stops
+    // the thread with the last recorder.
+    void remove(Recorder& source) {
+        std::lock_guard<std::mutex> control(controlLock);
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            auto it = std::find_if(outputs.begin(), outputs.end(), [&](const Output& o) { return o.recorder == &source; });
+            if (it == outputs.end()) return;
+            source.setActive(false);
+            drainInto(*it);
+            it->file.close();
+            outputs.erase(it);
+            last = outputs.empty();
+        }
+        if (last) stopThread();
+    }
+
+private:
+    struct Output {
+        Recorder* recorder = nullptr;
+        std::filesystem::path path;
+        std::ofstream file;
+        uint64_t bytesWritten = 0;
+        uint64_t reportedDrops = 0;
+    };
+
+    void stopThread() {
+        if (!thread.joinable()) return;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        thread.join();
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (!stopping) {
+            wake.wait_for(guard, DRAIN_INTERVAL, [this] { return stopping; });
+            for (auto& out : outputs) drainInto(out);
+        }
+    }
+
+    // With lock held.
+    void drainInto(Output& out) {
+        batch.clear();
+        out.recorder->drain(batch);
+        const uint64_t drops = out.recorder->droppedCount();
+        if (drops != out.reportedDrops) {
+            Event e;
+            e.timeNs = nowNs();
+            e.type = Dropped;
+            e.a = (float)drops;
+            batch.push_back(e);
+            out.reportedDrops = drops;
+        }
+        if (!batch.empty()) write(out);
+    }
+
+    void write(Output& out) {
+        if (out.file.is_open() && out.bytesWritten >= MAX_LOG_BYTES) {
+            out.file.close();
+            std::error_code ec;
+            auto old = out.path;
+            old += ".old";
+            std::filesystem::rename(out.path, old, ec);
+        }
+        if (!out.file.is_open()) {
+            std::error_code ec;
+            std::filesystem::create_directories(out.path.parent_path(), ec);
+            out.file.open(out.path, std::ios::binary | std::ios::trunc);
+            if (!out.file) return;
+            prune(out.path.parent_path());
+            FileHeader header;
+            header.wallClockNs = (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            header.steadyNs = nowNs();
+            out.file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.bytesWritten = sizeof(header);
+        }
+        const size_t bytes = batch.size() * sizeof(Event);
+        out.file.write(reinterpret_cast<const char*>(batch.data()), (std::streamsize)bytes);
+        out.file.flush();
+        out.bytesWritten += bytes;
+    }
+
+    static bool isLogName(const std::string& name) {
+        auto endsWith = [&](const char* suffix) {
+            const size_t n = std::strlen(suffix);
+            return name.size() >= n && name.compare(name.size() - n, n, suffix) == 0;
+        };
+        return endsWith(".fdnlog") || endsWith(".fdnlog.old");
+    }
+
+    // Deletes all but the newest MAX_LOG_FILES logs in folder, never one
+    // that is still being written. With lock held.
+    void prune(const std::filesystem::path& folder) {
+        namespace fs = std::filesystem;
+        std::vector<std::pair<fs::file_time_type, fs::path>> logs;
+        std::error_code ec;
+        for (fs::directory_iterator it(folder, ec), end; !ec && it != end; it.increment(ec)) {
+            const fs::path& path = it->path();
+            if (!isLogName(path.filename().string())) continue;
+            const bool live = std::any_of(outputs.begin(), outputs.end(), [&](const Output& o) { return o.path == path; });
+            if (live) continue;
+            std::error_code timeError;
+            const auto time = it->last_write_time(timeError);
+            if (!timeError) logs.emplace_back(time, path);
+        }
+        const size_t live = (size_t)std::count_if(outputs.begin(), outputs.end(),
+            [&](const Output& o) { return o.file.is_open() && o.path.parent_path() == folder; });
+        const size_t keep = MAX_LOG_FILES > live ? MAX_LOG_FILES - live : 0;
+        if (logs.size() <= keep) return;
+        std::sort(logs.begin(), logs.end(), [](const auto& x, const auto& y) { return x.first > y.first; });
+        for (size_t i = keep; i < logs.size(); ++i) fs::remove(logs[i].second, ec);
+    }
+
+    std::vector<Output> outputs;
+    std::vector<Event> batch;
+    std::thread thread;
+    std::mutex controlLock; // add/remove, held across the thread's start and join
+    std::mutex lock;        // outputs, batch, stopping
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+} // namespace FDNFlight
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+    FDN_Memory.h
+    Phase 189: Huge-Page Delay Memory
+
+    UPDATES:
+    - HugePageAllocator for the multi-megabyte delay buffers.
+    - Linux: explicit hugetlbfs (MAP_HUGETLB) first, then THP (MADV_HUGEPAGE),
+      then plain pages. Other platforms fall back to aligned new.
+    - Optional mlock so the audio thread never takes a page fault.
+    - Per-block flags can be queried to report what was actually obtained.
+  ==============================================================================
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <limits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace FDNMemory {
+
+static constexpr std::size_t HUGE_PAGE_SIZE = 2u * 1024u * 1024u;
+static constexpr std::size_t HUGE_PAGE_THRESHOLD = 1024u * 1024u; // below this, plain new
+static constexpr std::size_t BLOCK_HEADER_SIZE = 64;               // keeps data cache-line aligned
+
+enum BlockFlags : uint32_t {
+    BlockMapped   = 1u << 0, // came from mmap (else aligned new)
+    BlockHugeTLB  = 1u << 1, // explicit hugetlbfs pages
+    BlockTHP      = 1u << 2, // transparent huge pages advised
+    BlockLocked   = 1u << 3  // mlock succeeded
+};
+
+struct BlockHeader {
+    std::size_t mappedBytes = 0;
+    uint32_t flags = 0;
+    uint32_t magic = 0;
+};
+static constexpr uint32_t BLOCK_MAGIC = 0x46444e4du; // 'FDNM'
+
+inline std::atomic<bool>& lockPolicy() {
+    static std::atomic<bool> lockPages{ false };
+    return lockPages;
+}
+
+// Call before prepare(): subsequent large allocations are mlock'ed.
+inline void setLockPages(bool shouldLock) { lockPolicy().store(shouldLock); }
+inline bool getLockPages() { return lockPolicy().load(); }
+
+inline void* allocateBlock(std::size_t bytes) {
+    const std::size_t total = bytes + BLOCK_HEADER_SIZE;
+    void* base = nullptr;
+    uint32_t flags = 0;
+    std::size_t mapped = total;
+
+#if defined(__linux__)
+    if (bytes >= HUGE_PAGE_THRESHOLD) {
+        mapped = (total + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+#if defined(MAP_HUGETLB)
+        void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) { base = p; flags |= BlockMapped | BlockHugeTLB; }
+#endif
+        if (base == nullptr) {
+            void* p2 = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p2 != MAP_FAILED) {
+                base = p2;
+                flags |= BlockMapped;
+#if defined(MADV_HUGEPAGE)
+                if (madvise(p2, mapped, MADV_HUGEPAGE) == 0) flags |= BlockTHP;
+#endif
+            }
+        }
+        if (base != nullptr && getLockPages()) {
+            if (mlock(base, mapped) == 0) flags |= BlockLocked;
+        }
+    }
+#endif
+
+    if (base == nullptr) {
+        mapped = total;
+        base = ::operator new(total, std::align_val_t(BLOCK_HEADER_SIZE));
+    }
+
+    auto* header = static_cast<BlockHeader*>(base);
+    header->mappedBytes = mapped;
+    header->flags = flags;
+    header->magic = BLOCK_MAGIC;
+    return static_cast<char*>(base) + BLOCK_HEADER_SIZE;
+}
+
+inline const BlockHeader* headerOf(const void* data) {
+    if (data == nullptr) return nullptr;
+    auto* header = reinterpret_cast<const BlockHeader*>(static_cast<const char*>(data) - BLOCK_HEADER_SIZE);
+    return (header->magic == BLOCK_MAGIC) ? header : nullptr;
+}
+
+inline void freeBlock(void* data) {
+    if (data == nullptr) return;
+    void* base = static_cast<char*>(data) - BLOCK_HEADER_SIZE;
+    auto* header = static_cast<BlockHeader*>(base);
+    const uint32_t flags = header->flags;
+    const std::size_t mapped = header->mappedBytes;
+    header->magic = 0;
+#if defined(__linux__)
+    if (flags & BlockMapped) {
+        if (flags & BlockLocked) munlock(base, mapped);
+        munmap(base, mapped);
+        return;
+    }
+#endif
+    (void)flags; (void)mapped;
+    ::operator delete(base, std::align_val_t(BLOCK_HEADER_SIZE));
+}
+
+inline uint32_t queryFlags(const void* data) {
+    auto* header = headerOf(data);
+    return header ? header->flags : 0u;
+}
+
+template <typename T>
+struct HugePageAllocator {
+    using value_type = T;
+    HugePageAllocator() noexcept = default;
+    template <typename U> HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_alloc();
+        return static_cast<T*>(allocateBlock(n * sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t) noexcept { freeBlock(p); }
+
+    template <typename U> bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+    template <typename U> bool operator!=(const HugePageAllocator<U>&) const noexcept { return false; }
+};
+
+struct MemoryReport {
+    std::size_t totalBytes = 0;
+    std::size_t hugeTlbBytes = 0;   // explicit 2 MB pages
+    std::size_t thpBytes = 0;       // advised for transparent huge pages
+    std::size_t lockedBytes = 0;
+    int numBuffers = 0;
+    int numHugeBuffers = 0;
+
+    bool hasHugePages() const { return numHugeBuffers > 0; }
+    bool allHugePages() const { return numBuffers > 0 && numHugeBuffers == numBuffers; }
+
+    template <typename Buffer>
+    void add(const Buffer& buffer) {
+        if (buffer.empty()) return;
+        const std::size_t bytes = buffer.size() * sizeof(typename Buffer::value_type);
+        const uint32_t flags = queryFlags(buffer.data());
+        totalBytes += bytes;
+        numBuffers++;
+        if (flags & BlockHugeTLB) hugeTlbBytes += bytes;
+        if (flags & BlockTHP) thpBytes += bytes;
+        if (flags & BlockLocked) lockedBytes += bytes;
+        if (flags & (BlockHugeTLB | BlockTHP)) numHugeBuffers++;
+    }
+};
+
+} // namespace FDNMemory
@@ -134,7 +134,8 @@ void AbsorptionGraph::paint(juce::Graphics& g) {
         }
         fillPath.lineTo(padding + 5 * stepX, h);
         fillPath.closeSubPath();
-        float level = processor.currentOutputLevel.load();
+        const auto& analysis = processor.getAnalysis();
+        float level = std::max(analysis.peak[0], analysis.peak[1]);
         float glowAlpha = std::clamp(level * 2.5f, 0.0f, 1.0f) * 0.5f + 0.2f;
         float lineThick = 3.0f + level * 3.0f;
         juce::Colour cLow = juce::Colours::darkorange;
@@ -164,6 +165,21 @@ void AbsorptionGraph::paint(juce::Graphics& g) {
         g.drawText("SFX RESONATOR MODE", getLocalBounds(), juce::Justification::centred);
     }
 
+    // Measured T30 (T20 where the decay is too long for T30) as white rings.
+    const auto& measured = processor.getMeasuredDecay();
+    if (measured.serial != 0) {
+        g.setColour(juce::Colours::white);
+        for (int i = 0; i < 6; ++i) {
+            float t = (measured.t30[i] > 0.0f) ? measured.t30[i] : measured.t20[i];
+            if (t <= 0.0f) continue;
+            float x = padding + i * stepX;
+            float y = norm(t);
+            g.drawEllipse(x - 5.0f, y - 5.0f, 10.0f, 10.0f, 2.0f);
+        }
+        g.setFont(12.0f);
+        g.drawText("o Measured", (int)w - 125, 5, 120, 20, juce::Justification::topRight);
+    }
+
     g.setColour(juce::Colours::white);
     g.setFont(14.0f);
     g.drawText("Estimated RT60 (6-Band)", 5, 5, 200, 20, juce::Justification::topLeft);
@@ -175,6 +191,39 @@ void AbsorptionGraph::paint(juce::Graphics& g) {
     }
 }
 
+#if FDN_PROFILE
+// ==============================================================================
+// Stage Profile Implementation
+// ==============================================================================
+void StageProfileView::timerCallback() {
+    breakdown = processor.getStageProfile();
+    repaint();
+}
+
+void StageProfileView::paint(juce::Graphics& g) {
+    g.fillAll(juce::Colour(0xff252525));
+    g.setColour(juce::Colours::white);
+    g.setFont(14.0f);
+    g.drawText(juce::String("Stage Profile (") + (breakdown.cycles ? "cycles" : "ns") + "/sample)",
+        5, 5, getWidth() - 10, 20, juce::Justification::topLeft);
+    if (!breakdown.valid) return;
+
+    g.setFont(12.0f);
+    const int rowH = std::max(12, (getHeight() - 30) / StageProfiler::NUM_STAGES);
+    const int nameW = getWidth() / 2;
+    for (int s = 0; s < StageProfiler::NUM_STAGES; ++s) {
+        const int y = 28 + s * rowH;
+        const double share = breakdown.share[(size_t)s];
+        g.setColour(juce::Colours::orange.withAlpha(0.35f));
+        g.fillRect(juce::Rectangle<float>((float)nameW, (float)y + 1.0f, (float)((getWidth() - nameW - 5) * share), (float)rowH - 2.0f));
+        g.setColour(juce::Colours::white);
+        g.drawText(StageProfiler::stageName(s), 5, y, nameW - 10, rowH, juce::Justification::centredLeft);
+        g.drawText(juce::String(breakdown.perSample[(size_t)s], 1) + "  " + juce::String(share * 100.0, 1) + "%",
+            nameW, y, getWidth() - nameW - 5, rowH, juce::Justification::centredRight);
+    }
+}
+#endif
+
 // ==============================================================================
 // DynamicsPanel Implementation
 // ==============================================================================
@@ -283,7 +332,8 @@ void RoomVisualizer::paint(juce::Graphics& g) {
     float srcX = safeDist * std::sin(panAngle);
     float srcZ = safeDist * std::cos(panAngle);
 
-    float audioLevel = processor.currentOutputLevel.load();
+    const auto& analysis = processor.getAnalysis();
+    float audioLevel = std::max(analysis.peak[0], analysis.peak[1]);
     float pulse = 1.0f + audioLevel * 0.15f;
 
     std::vector<Point3D> vertices;
@@ -513,6 +563,14 @@ FdnReverbAudioProcessorEditor::FdnReverbAudioProcessorEditor(FdnReverbAudioProce
 
     addAndMakeVisible(roomVis);
     addAndMakeVisible(absorptionGraph);
+#if FDN_PROFILE
+    stageProfileView = std::make_unique<StageProfileView>(p);
+    addAndMakeVisible(*stageProfileView);
+    absorptionGraph.setVisible(false);
+#else
+    // Measured decay for the absorption graph, rendered while the editor is open.
+    audioProcessor.setDecayAnalysisEnabled(true);
+#endif
 
     buildFactoryPresetMenu();
     buildUserPresetMenu();
@@ -559,6 +617,7 @@ FdnReverbAudioProcessorEditor::FdnReverbAudioProcessorEditor(FdnReverbAudioProce
 
 FdnReverbAudioProcessorEditor::~FdnReverbAudioProcessorEditor() {
     stopTimer();
+    audioProcessor.setDecayAnalysisEnabled(false);
     removeAllChildren();
     juce::LookAndFeel::setDefaultLookAndFeel(nullptr);
 }
@@ -732,6 +791,13 @@ void FdnReverbAudioProcessorEditor::timerCallback() {
     text << "2k:" << juce::String(rt60.decay[4], 1) << " ";
     text << "4k:" << juce::String(rt60.decay[5], 1);
 
+    const int tier = audioProcessor.getQualityTier();
+    text << "  CPU:" << juce::String(juce::roundToInt(audioProcessor.getCallbackLoad() * 100.0f)) << "%";
+    if (tier > 0) text << " T" << tier;
+    const auto stats = audioProcessor.getCallbackStats();
+    text << " p99:" << juce::String(juce::roundToInt(stats.p99Load * 100.0)) << "%";
+    if (stats.overruns > 0) text << " xrun:" << juce::String((juce::int64)stats.overruns);
+
     rt60Label.setText(text, juce::dontSendNotification);
 
     if (audioProcessor.getCurrentPresetName() != presetButton.getButtonText()) {
@@ -779,6 +845,9 @@ void FdnReverbAudioProcessorEditor::resized() {
     int visWidth = visArea.getWidth() / 2;
     roomVis.setBounds(visArea.removeFromLeft(visWidth).reduced(5));
     absorptionGraph.setBounds(visArea.reduced(5));
+#if FDN_PROFILE
+    stageProfileView->setBounds(absorptionGraph.getBounds());
+#endif
 
     auto filterArea = area.removeFromBottom(60);
     int filterW = filterArea.getWidth() / 4;
@@ -108,6 +108,19 @@ private:
     FdnReverbAudioProcessor& processor;
 };
 
+#if FDN_PROFILE
+// Profiling builds only: per-stage cost table, shown in place of the absorption graph.
+class StageProfileView : public juce::Component, public juce::Timer {
+public:
+    StageProfileView(FdnReverbAudioProcessor& p) : processor(p) { startTimerHz(4); }
+    void timerCallback() override;
+    void paint(juce::Graphics& g) override;
+private:
+    FdnReverbAudioProcessor& processor;
+    StageProfiler::Breakdown breakdown;
+};
+#endif
+
 // --- Advanced Dynamics Panel Class Definition ---
 class DynamicsPanel : public juce::Component {
 public:
@@ -157,6 +170,9 @@ private:
     InfoBar infoBar;
     RoomVisualizer roomVis;
     AbsorptionGraph absorptionGraph;
+#if FDN_PROFILE
+    std::unique_ptr<StageProfileView> stageProfileView;
+#endif
 
     // The Overlay Panel
     DynamicsPanel dynamicsPanel;
@@ -180,6 +180,14 @@ static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout
 
     addPercent("diffusion", utf8(u8"Diffusion (拡散)"), 0.0f, 1.0f, 0.8f);
 
+    juce::StringArray diffLengths;
+    diffLengths.add("50 ms"); diffLengths.add("100 ms"); diffLengths.add("200 ms"); diffLengths.add("350 ms"); diffLengths.add("500 ms");
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("diff_length", utf8(u8"Diff Length (拡散長)"), diffLengths, 0));
+
+    juce::StringArray erOrders;
+    erOrders.add("3"); erOrders.add("4"); erOrders.add("5"); erOrders.add("6");
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("er_order", utf8(u8"ER Order (反射次数)"), erOrders, 0));
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>("width_st", utf8(u8"Stereo W (広がり)"),
         juce::NormalisableRange<float>(0.0f, 2.0f), 1.0f,
         juce::String(),
@@ -193,6 +201,11 @@ static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout
     juce::StringArray qualities;
     qualities.add("Off"); qualities.add("2x"); qualities.add("4x");
     params.push_back(std::make_unique<juce::AudioParameterChoice>("quality", utf8(u8"Quality (品質)"), qualities, 0));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("multicore", utf8(u8"Multi-Core (マルチコア)"), false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("pipeline", utf8(u8"Pipeline +1 Block (パイプライン)"), false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("autoQuality", utf8(u8"Auto Quality (自動品質)"), false));
+    addPercent("autoQualityDown", utf8(u8"Auto Quality Down (負荷上限)"), 0.3f, 1.0f, 0.8f);
+    addPercent("autoQualityUp", utf8(u8"Auto Quality Up (負荷下限)"), 0.05f, 0.8f, 0.35f);
 
     addPercent("drive", utf8(u8"Drive (歪み)"), 0.0f, 1.0f, 0.0f);
     addPercent("density", utf8(u8"Density (密度)"), 0.0f, 1.0f, 0.0f);
@@ -298,10 +311,17 @@ FdnReverbAudioProcessor::FdnReverbAudioProcessor()
     heightSourceParam = parameters.getRawParameterValue("src_height");
     shapeParam = parameters.getRawParameterValue("shape");
     diffParam = parameters.getRawParameterValue("diffusion");
+    diffLengthParam = parameters.getRawParameterValue("diff_length");
+    erOrderParam = parameters.getRawParameterValue("er_order");
     widthStereoParam = parameters.getRawParameterValue("width_st");
     levelParam = parameters.getRawParameterValue("level");
 
     qualityParam = parameters.getRawParameterValue("quality");
+    multicoreParam = parameters.getRawParameterValue("multicore");
+    pipelineParam = parameters.getRawParameterValue("pipeline");
+    autoQualityParam = parameters.getRawParameterValue("autoQuality");
+    autoQualityDownParam = parameters.getRawParameterValue("autoQualityDown");
+    autoQualityUpParam = parameters.getRawParameterValue("autoQualityUp");
     driveParam = parameters.getRawParameterValue("drive");
     densityParam = parameters.getRawParameterValue("density");
 
@@ -318,13 +338,78 @@ FdnReverbAudioProcessor::FdnReverbAudioProcessor()
     dynReleaseParam = parameters.getRawParameterValue("dyn_release");
 
     initPresets();
+
+    // One log per instance, created on the first event. Off unless the
+    // environment asks for it (FDN_FLIGHT_LOG=1) or setFlightLogEnabled is called.
+    flightLogFile = getUserPresetFolder().getSiblingFile("FDN_Reverb_Logs")
+        .getChildFile("flight_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S")
+            + "_" + juce::String::toHexString((juce::pointer_sized_int)this) + ".fdnlog");
+    const juce::String flightLogFlag = juce::SystemStats::getEnvironmentVariable("FDN_FLIGHT_LOG", {});
+    setFlightLogEnabled(flightLogFlag.isNotEmpty() && flightLogFlag != "0");
+
+    startTimerHz(4);
 }
 
 FdnReverbAudioProcessor::~FdnReverbAudioProcessor() {
+    stopTimer();
+    setFlightLogEnabled(false);
     oversampling2x.reset();
     oversampling4x.reset();
 }
+
+void FdnReverbAudioProcessor::setFlightLogEnabled(bool shouldRecord) {
+    if (shouldRecord == flightLogEnabled) return;
+    if (shouldRecord) FDNFlight::LogWriter::shared().add(flightRecorder, flightLogFile.getFullPathName().toStdString());
+    else FDNFlight::LogWriter::shared().remove(flightRecorder);
+    flightLogEnabled = shouldRecord;
+}
+
+void FdnReverbAudioProcessor::setDecayAnalysisEnabled(bool shouldAnalyse) {
+    if (shouldAnalyse) {
+        decayAnalyzer.start();
+        decayRequestPending.store(true); // measure the current settings right away
+    }
+    else {
+        decayAnalyzer.stop();
+    }
+}
+
+void FdnReverbAudioProcessor::publishAnalysis(const juce::AudioBuffer<float>& buffer) {
+    AnalysisSnapshot& snapshot = analysis.writeBuffer();
+    snapshot.sequence = ++analysisSequence;
+    snapshot.rt60 = fdnEngine.getEstimatedRT60();
+    const int numSamples = buffer.getNumSamples();
+    for (int ch = 0; ch < 2; ++ch) {
+        const int source = std::min(ch, buffer.getNumChannels() - 1);
+        snapshot.peak[(size_t)ch] = buffer.getMagnitude(source, 0, numSamples);
+        snapshot.rms[(size_t)ch] = buffer.getRMSLevel(source, 0, numSamples);
+    }
+    snapshot.loopEnergy = fdnEngine.getLoopEnergy();
+    snapshot.idle = std::max(snapshot.peak[0], snapshot.peak[1]) < AnalysisSnapshot::IDLE_LEVEL
+        && snapshot.loopEnergy < AnalysisSnapshot::IDLE_LEVEL * AnalysisSnapshot::IDLE_LEVEL;
+    analysis.publish();
+}
+
+void FdnReverbAudioProcessor::recordPhysicsChanges(const PhysicsState& before, const PhysicsState& after) {
+    const auto oldFields = before.fields();
+    const auto newFields = after.fields();
+    for (int i = 0; i < FDNFlight::NUM_PHYSICS_FIELDS; ++i) {
+        if (oldFields[(size_t)i] != newFields[(size_t)i])
+            flightRecorder.push(FDNFlight::ParamChange, (uint16_t)i, oldFields[(size_t)i], newFields[(size_t)i]);
+    }
+}
+// Factory presets are immutable and shared by every instance in the process.
+static void buildFactoryPresets(std::vector<ReverbPreset>& presets);
+
 void FdnReverbAudioProcessor::initPresets() {
+    presets = SharedTables::instance<int, std::vector<ReverbPreset>>().get(0, [] {
+        std::vector<ReverbPreset> table;
+        buildFactoryPresets(table);
+        return table;
+    });
+}
+
+static void buildFactoryPresets(std::vector<ReverbPreset>& presets) {
     presets.clear();
 
     // Helper lambda to safely construct presets regardless of struct memory layout
@@ -1388,11 +1473,11 @@ bool FdnReverbAudioProcessor::acceptsMidi() const { return false; }
 bool FdnReverbAudioProcessor::producesMidi() const { return false; }
 bool FdnReverbAudioProcessor::isMidiEffect() const { return false; }
 double FdnReverbAudioProcessor::getTailLengthSeconds() const { return 2.0; }
-int FdnReverbAudioProcessor::getNumPrograms() { return (int)presets.size(); }
+int FdnReverbAudioProcessor::getNumPrograms() { return (int)getPresets().size(); }
 int FdnReverbAudioProcessor::getCurrentProgram() { return 0; }
 void FdnReverbAudioProcessor::setCurrentProgram(int index) { loadPreset(index); }
 const juce::String FdnReverbAudioProcessor::getProgramName(int index) {
-    if (index >= 0 && index < (int)presets.size()) return presets[index].name;
+    if (index >= 0 && index < (int)getPresets().size()) return getPresets()[index].name;
     return {};
 }
 void FdnReverbAudioProcessor::changeProgramName(int index, const juce::String& newName) {}
@@ -1436,11 +1521,41 @@ bool FdnReverbAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 void FdnReverbAudioProcessor::releaseResources() {
     oversampling2x.reset();
     oversampling4x.reset();
+    {
+        const std::lock_guard<std::mutex> guard(workerLock);
+        workerMaxLatency = 0;
+        fdnEngine.stopParallelWorkers();
+        fdnEngine.stopPipelineWorker();
+    }
+    flightRecorder.push(FDNFlight::Release);
+}
+
+void FdnReverbAudioProcessor::startEnabledWorkers() {
+    const std::lock_guard<std::mutex> guard(workerLock);
+    if (workerMaxLatency == 0) return;
+    if (multicoreParam->load() > 0.5f) fdnEngine.startParallelWorkers();
+    if (pipelineParam->load() > 0.5f) fdnEngine.startPipelineWorker(workerMaxLatency);
+}
+
+void FdnReverbAudioProcessor::timerCallback() {
+    const bool wantParallel = multicoreParam->load() > 0.5f && !fdnEngine.isParallelAvailable();
+    const bool wantPipeline = pipelineParam->load() > 0.5f && !fdnEngine.isPipelineAvailable();
+    if (wantParallel || wantPipeline) startEnabledWorkers();
+}
+
+// Oversampling latency plus, when pipelined, the engine's extra block
+// (reported by the engine at the DSP rate).
+void FdnReverbAudioProcessor::updateLatency() {
+    reportedPipelineLatency = fdnEngine.getPipelineLatency();
+    int latency = currentOversampling ? (int)currentOversampling->getLatencyInSamples() : 0;
+    latency += reportedPipelineLatency >> currentOversamplingFactor;
+    setLatencySamples(latency);
 }
 
 void FdnReverbAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     storedSampleRate = sampleRate;
     storedBlockSize = samplesPerBlock;
+    flightRecorder.push(FDNFlight::Prepare, 0, (float)sampleRate, (float)samplesPerBlock);
 
     int factor = 0;
     int qualityIdx = (int)qualityParam->load();
@@ -1459,6 +1574,10 @@ void FdnReverbAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlo
 
     currentOversamplingFactor = factor;
 
+    // Velvet backend timing and tables for every rate a quality switch can
+    // select, held so a switch on the audio thread never rebuilds them.
+    for (int f = 0; f <= 2; ++f) velvetTables[(size_t)f] = VelvetDiffuser::calibrate((float)sampleRate * (float)(1 << f));
+
     float maxPossibleSampleRate = (float)sampleRate * 4.0f;
     fdnEngine.prepare(maxPossibleSampleRate);
 
@@ -1467,13 +1586,28 @@ void FdnReverbAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlo
     storedDspSampleRate = dspSampleRate;
     lastQualityFactor = factor;
 
-    if (currentOversampling) setLatencySamples(currentOversampling->getLatencyInSamples());
-    else setLatencySamples(0);
+    {
+        // Room for a host block at 4x. Restarting at a new size is only
+        // safe here, with no callback running.
+        const std::lock_guard<std::mutex> guard(workerLock);
+        workerMaxLatency = samplesPerBlock << 2;
+        if (fdnEngine.isPipelineAvailable()) fdnEngine.startPipelineWorker(workerMaxLatency);
+    }
+    startEnabledWorkers();
+    fdnEngine.setPipelined(pipelineParam->load() > 0.5f, samplesPerBlock << factor);
+
+    updateLatency();
+
+    governor.reset();
+    activeTier = pendingTier = 0;
+    tierFade = TierFade::None;
+    appliedQualityTier.store(0);
 
     forceUpdate = true;
 }
 
 void FdnReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    const auto callbackStart = std::chrono::steady_clock::now();
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -1481,6 +1615,7 @@ void FdnReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
         buffer.clear(i, 0, buffer.getNumSamples());
 
     if (panicTriggered.exchange(false)) {
+        flightRecorder.push(FDNFlight::Panic);
         fdnEngine.reset();
         forceUpdate = true;
         return;
@@ -1491,17 +1626,55 @@ void FdnReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
     if (qualityIdx == 1) factor = 1;
     else if (qualityIdx == 2) factor = 2;
 
+    // Auto quality. Tier 1 cuts the velvet and ER stages to their cheapest
+    // settings. Oversampling stays as set: switching it re-prepares the
+    // engine, which drops the tail and changes the latency. The wet path
+    // fades out over one block, the tier applies at the start of the next,
+    // and the wet fades back in once the new stages reach the output (one
+    // block later when pipelined). The dry signal is never touched.
+    governor.setMaxTier(1);
+    governor.setThresholds(autoQualityDownParam->load(), autoQualityUpParam->load());
+    const int wantedTier = (autoQualityParam->load() > 0.5f) ? governor.getTier() : 0;
+    bool reconfigured = false;
+    float wetFadeTarget = -1.0f; // < 0: leave the wet fade alone
+    if (tierFade == TierFade::Out) {
+        flightRecorder.push(FDNFlight::QualitySwitch, (uint16_t)pendingTier,
+            (float)(1 << currentOversamplingFactor), (float)(1 << currentOversamplingFactor));
+        activeTier = pendingTier;
+        appliedQualityTier.store(activeTier);
+        reconfigured = true;
+        if (fdnEngine.getPipelineLatency() > 0) {
+            tierFade = TierFade::Hold;
+        }
+        else {
+            tierFade = TierFade::None;
+            wetFadeTarget = 1.0f;
+        }
+    }
+    else if (tierFade == TierFade::Hold) {
+        tierFade = TierFade::None;
+        wetFadeTarget = 1.0f;
+    }
+    else if (wantedTier != activeTier) {
+        pendingTier = wantedTier;
+        tierFade = TierFade::Out;
+        wetFadeTarget = 0.0f;
+    }
+    const bool liteFeedForward = activeTier > 0;
+
     if (currentOversamplingFactor != factor) {
+        flightRecorder.push(FDNFlight::QualitySwitch, (uint16_t)activeTier,
+            (float)(1 << currentOversamplingFactor), (float)(1 << factor));
         currentOversamplingFactor = factor;
         if (factor == 1)      currentOversampling = oversampling2x.get();
         else if (factor == 2) currentOversampling = oversampling4x.get();
         else                  currentOversampling = nullptr;
 
         if (currentOversampling) currentOversampling->reset();
-        if (currentOversampling) setLatencySamples(currentOversampling->getLatencyInSamples());
-        else setLatencySamples(0);
+        updateLatency();
 
         forceUpdate = true;
+        reconfigured = true;
     }
 
     float dspSampleRate = (float)getSampleRate() * (float)(1 << factor);
@@ -1510,8 +1683,13 @@ void FdnReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
         storedDspSampleRate = dspSampleRate;
         lastQualityFactor = factor;
         forceUpdate = true;
+        reconfigured = true;
     }
 
+    // One host block of latency, whatever the oversampling factor.
+    fdnEngine.setPipelined(pipelineParam->load() > 0.5f, storedBlockSize << factor);
+    if (fdnEngine.getPipelineLatency() != reportedPipelineLatency) updateLatency();
+
     juce::dsp::AudioBlock<float> block(buffer);
     juce::dsp::AudioBlock<float> processBlock = block;
     juce::dsp::AudioBlock<float> upsampledBlock;
@@ -1552,6 +1730,12 @@ void FdnReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
 
     int shape = (int)shapeParam->load();
     float diff = diffParam->load();
+    int diffLen = (int)diffLengthParam->load();
+    int erOrder = MIN_ER_ORDER + (int)erOrderParam->load();
+    if (liteFeedForward) {
+        diffLen = 0;
+        erOrder = MIN_ER_ORDER;
+    }
     float stW = widthStereoParam->load();
     float outLvl = levelParam->load();
 
@@ -1574,48 +1758,67 @@ void FdnReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
         inLC, inHC, outLC, outHC, dist, pan, srcH, shape, diff, stW, outLvl,
         density, drive, decay, 
         dynamics, tilt, dynThresh, dynRatio, dynAtt, dynRel,
-        (int)processBlock.getNumSamples()
+        diffLen, erOrder, (int)processBlock.getNumSamples()
     };
 
     if (forceUpdate || currentState != lastPhysicsState) {
-        // Correct 34 Arguments Call for Phase 182
-        fdnEngine.updatePhysics(
-            w, d, h, mf, mc, mws, mwfb, absOv, mRate, mDepth, pre, temp, hum, mix, 
-            inLC, inHC, outLC, outHC, dist, pan, srcH, shape, diff, stW, outLvl, 
-            density, drive, dynamics, tilt, 
-            dynThresh, dynRatio, dynAtt, dynRel, // New args
-            processBlock.getNumSamples(), decay
-        );
+        recordPhysicsChanges(lastPhysicsState, currentState);
+        const auto updateStart = std::chrono::steady_clock::now();
+        PhysicsParams physics;
+        physics.width = w; physics.depth = d; physics.height = h;
+        physics.matFloor = mf; physics.matCeil = mc; physics.matWallSide = mws; physics.matWallFB = mwfb;
+        physics.absorption = absOv;
+        physics.modRate = mRate; physics.modDepth = mDepth; physics.predelayMs = pre;
+        physics.tempC = temp; physics.humidityPct = hum; physics.dryWet = mix;
+        physics.inLC = inLC; physics.inHC = inHC; physics.outLC = outLC; physics.outHC = outHC;
+        physics.sourceDist = dist; physics.sourcePan = pan; physics.sourceHeight = srcH;
+        physics.roomShape = shape; physics.diffusion = diff; physics.stereoWidth = stW; physics.outputLevel = outLvl;
+        physics.density = density; physics.drive = drive; physics.decay = decay;
+        physics.dynamics = dynamics; physics.tilt = tilt;
+        physics.dynThreshold = dynThresh; physics.dynRatio = dynRatio; physics.dynAttack = dynAtt; physics.dynRelease = dynRel;
+        physics.diffusionLength = diffLen;
+        physics.erOrder = erOrder;
+        fdnEngine.setSynchronousERSolve(isNonRealtime());
+        fdnEngine.updatePhysics(physics, processBlock.getNumSamples());
+        callbackStats.notePhysicsUpdate();
+        flightRecorder.push(FDNFlight::PhysicsUpdate, 0,
+            (float)std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - updateStart).count());
             
         lastPhysicsState = currentState;
+        lastPhysicsParams = physics;
+        decayRequestPending.store(true);
         forceUpdate = false;
     }
+    // No-op unless the editor has the analyzer running.
+    if (decayRequestPending.exchange(false)) decayAnalyzer.request(lastPhysicsParams);
 
     float* outL = processBlock.getChannelPointer(0);
     float* outR = (processBlock.getNumChannels() > 1) ? processBlock.getChannelPointer(1) : nullptr;
     float* inputs[] = { outL, outR };
     float* outputs[] = { outL, outR };
 
+    fdnEngine.setParallelProcessing(multicoreParam->load() > 0.5f);
+    if (wetFadeTarget >= 0.0f) fdnEngine.fadeWet(wetFadeTarget, (int)processBlock.getNumSamples());
     fdnEngine.process(inputs, outputs, (int)processBlock.getNumSamples(), processBlock.getNumChannels());
 
     if (currentOversampling != nullptr) {
         currentOversampling->processSamplesDown(block);
     }
 
-    float maxAmp = 0.0f;
-    const float* readL = buffer.getReadPointer(0);
-    int numSamps = buffer.getNumSamples();
-    for (int i = 0; i < numSamps; i += 8) {
-        float abs = std::abs(readL[i]);
-        if (abs > maxAmp) maxAmp = abs;
-    }
-    currentOutputLevel.store(maxAmp, std::memory_order_relaxed);
+    publishAnalysis(buffer);
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - callbackStart).count();
+    const double period = (double)buffer.getNumSamples() / getSampleRate();
+    callbackStats.record(elapsed, period);
+    if (elapsed > period) flightRecorder.push(FDNFlight::CallbackOverrun, 0, (float)(elapsed * 1000.0), (float)(period * 1000.0));
+    // Callbacks that re-prepared the engine are not representative.
+    if (!reconfigured) governor.addCallback(elapsed, period);
 }
 
 // Preset Management Helpers
 void FdnReverbAudioProcessor::loadPreset(int index) {
-    if (index < 0 || index >= (int)presets.size()) return;
-    const auto& p = presets[index];
+    if (index < 0 || index >= (int)getPresets().size()) return;
+    const auto& p = getPresets()[index];
 
     auto setVal = [&](const juce::String& id, float val) {
         auto* param = parameters.getParameter(id);
@@ -1644,6 +1847,8 @@ void FdnReverbAudioProcessor::loadPreset(int index) {
     setVal("src_height", p.sourceHeight);
     setVal("shape", (float)p.roomShape);
     setVal("diffusion", p.diffusion);
+    setVal("diff_length", (float)p.diffLength);
+    setVal("er_order", (float)(p.erOrder - MIN_ER_ORDER));
     setVal("width_st", p.stereoWidth);
     setVal("level", p.outputLevel);
     setVal("drive", p.drive);
@@ -1698,6 +1903,8 @@ void FdnReverbAudioProcessor::saveUserPreset(const juce::String& name) {
     p.sourceHeight = getVal("src_height");
     p.roomShape = (int)getVal("shape");
     p.diffusion = getVal("diffusion");
+    p.diffLength = (int)getVal("diff_length");
+    p.erOrder = MIN_ER_ORDER + (int)getVal("er_order");
     p.stereoWidth = getVal("width_st");
     p.outputLevel = getVal("level");
     p.drive = getVal("drive");
@@ -1749,6 +1956,8 @@ void FdnReverbAudioProcessor::saveUserPreset(const juce::String& name) {
     xml.setAttribute("dyn_ratio", p.dynRatio);
     xml.setAttribute("dyn_attack", p.dynAttack);
     xml.setAttribute("dyn_release", p.dynRelease);
+    xml.setAttribute("diff_length", p.diffLength);
+    xml.setAttribute("er_order", p.erOrder);
 
     auto folder = getUserPresetFolder();
     if (!folder.exists()) folder.createDirectory();
@@ -1797,6 +2006,8 @@ void FdnReverbAudioProcessor::loadUserPreset(const juce::File& file) {
         p.dynRatio = (float)xml->getDoubleAttribute("dyn_ratio", 2.0);
         p.dynAttack = (float)xml->getDoubleAttribute("dyn_attack", 10.0);
         p.dynRelease = (float)xml->getDoubleAttribute("dyn_release", 100.0);
+        p.diffLength = xml->getIntAttribute("diff_length", 0);
+        p.erOrder = xml->getIntAttribute("er_order", MIN_ER_ORDER);
 
         // Apply
         auto setVal = [&](const juce::String& id, float val) {
@@ -1837,6 +2048,8 @@ void FdnReverbAudioProcessor::loadUserPreset(const juce::File& file) {
         setVal("dyn_ratio", p.dynRatio);
         setVal("dyn_attack", p.dynAttack);
         setVal("dyn_release", p.dynRelease);
+        setVal("diff_length", (float)p.diffLength);
+        setVal("er_order", (float)(p.erOrder - MIN_ER_ORDER));
 
         currentPresetName = p.name;
     }
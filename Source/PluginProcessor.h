@@ -13,65 +13,20 @@
 
 #include <JuceHeader.h>
 #include "FDN_DSP.h"
+#include "FDN_Engine.h"
+#include "FDN_FlightRecorder.h"
 #include <tuple>
 #include <atomic>
+#include <mutex>
 
 // --- Data Structures ---
 
-struct ReverbPreset {
+// The settings themselves live in FDNReverb::Settings (FDN_Engine.h), which
+// the JUCE-free engine library shares.
+struct ReverbPreset : FDNReverb::Settings {
     juce::String name;
     juce::String category;
     juce::String description;
-
-    // Core Physics
-    float width = 10.0f;
-    float depth = 10.0f;
-    float height = 5.0f;
-    int matFloor = 0;
-    int matCeil = 0;
-    int matWallSide = 0;
-    int matWallFB = 0;
-    float absorption = 0.5f;
-
-    // Modulation & Time
-    float modRate = 0.5f;
-    float modDepth = 0.2f;
-    float predelay = 0.0f;
-    float decay = 1.0f;
-
-    // Environment
-    float temp = 20.0f;
-    float humidity = 50.0f;
-
-    // Filters
-    float inLC = 20.0f;
-    float inHC = 20000.0f;
-    float outLC = 20.0f;
-    float outHC = 20000.0f;
-
-    // Source & Mix
-    float dist = 0.5f;
-    float pan = 0.0f;
-    float sourceHeight = 0.5f;
-    float mix = 0.3f;
-
-    // Character
-    int roomShape = 0;
-    float diffusion = 0.8f;
-    float stereoWidth = 1.0f;
-    float outputLevel = 1.0f;
-    float drive = 0.0f;
-    float density = 0.0f;
-
-    // Advanced Features
-    float dynamics = 0.0f; // Amount
-    float tilt = 0.0f;
-
-    // Phase 182: Dynamics Details
-    float dynThreshold = -20.0f;
-    float dynRatio = 2.0f;
-    float dynAttack = 10.0f;
-    float dynRelease = 100.0f;
 };
 
 struct PhysicsState {
@@ -90,20 +45,29 @@ struct PhysicsState {
     float dynRatio = 0.0f;
     float dynAtt = 0.0f;
     float dynRel = 0.0f;
+    int diffLen = 0;
+    int erOrder = 0;
 
     int samples = 0;
 
     bool operator!=(const PhysicsState& other) const {
         return std::tie(w, d, h, mf, mc, mws, mwfb, abs, mRate, mDepth, pre, temp, hum, mix,
             inLC, inHC, outLC, outHC, dist, pan, srcH, shape, diff, stW, outLvl, density, drive, decay,
-            dynamics, tilt, dynThresh, dynRatio, dynAtt, dynRel, samples)
+            dynamics, tilt, dynThresh, dynRatio, dynAtt, dynRel, diffLen, erOrder, samples)
             != std::tie(other.w, other.d, other.h, other.mf, other.mc, other.mws, other.mwfb, other.abs, other.mRate, other.mDepth, other.pre, other.temp, other.hum, other.mix,
                 other.inLC, other.inHC, other.outLC, other.outHC, other.dist, other.pan, other.srcH, other.shape, other.diff, other.stW, other.outLvl, other.density, other.drive, other.decay,
-                other.dynamics, other.tilt, other.dynThresh, other.dynRatio, other.dynAtt, other.dynRel, other.samples);
+                other.dynamics, other.tilt, other.dynThresh, other.dynRatio, other.dynAtt, other.dynRel, other.diffLen, other.erOrder, other.samples);
+    }
+
+    // Same order as operator!= and FDNFlight::physicsFieldName.
+    std::array<float, FDNFlight::NUM_PHYSICS_FIELDS> fields() const {
+        return { w, d, h, (float)mf, (float)mc, (float)mws, (float)mwfb, abs, mRate, mDepth, pre, temp, hum, mix,
+            inLC, inHC, outLC, outHC, dist, pan, srcH, (float)shape, diff, stW, outLvl, density, drive, decay,
+            dynamics, tilt, dynThresh, dynRatio, dynAtt, dynRel, (float)diffLen, (float)erOrder, (float)samples };
     }
 };
 
-class FdnReverbAudioProcessor : public juce::AudioProcessor
+class FdnReverbAudioProcessor : public juce::AudioProcessor, private juce::Timer
 {
 public:
     FdnReverbAudioProcessor();
@@ -138,20 +102,51 @@ public:
     void saveUserPreset(const juce::String& name);
     void loadUserPreset(const juce::File& file);
     juce::File getUserPresetFolder() const;
-    const std::vector<ReverbPreset>& getPresets() const { return presets; }
+    const std::vector<ReverbPreset>& getPresets() const { return *presets; }
     int getCurrentPresetIndex() const { return currentPresetIndex; }
     juce::String getCurrentPresetName() const { return currentPresetName; }
 
     juce::AudioProcessorValueTreeState parameters;
-    std::vector<ReverbPreset> presets;
+    std::shared_ptr<const std::vector<ReverbPreset>> presets;
     int currentPresetIndex = 0;
     juce::String currentPresetName = "Default";
 
-    // Metering
-    std::atomic<float> currentOutputLevel{ 0.0f };
     void triggerPanic() { panicTriggered.store(true); }
 
-    RT60Data getRT60() const { return fdnEngine.getEstimatedRT60(); }
+    // Latest analysis published by the audio thread. Message thread only;
+    // wait-free, and the reference stays valid until the next call.
+    const AnalysisSnapshot& getAnalysis() {
+        analysis.update();
+        return analysis.read();
+    }
+    RT60Data getRT60() { return getAnalysis().rt60; }
+    FDNMemory::MemoryReport getMemoryReport() const { return fdnEngine.getMemoryReport(); }
+
+    // Auto quality: smoothed callback load (fraction of the buffer period)
+    // and the tier currently applied (0 = as set).
+    float getCallbackLoad() const { return governor.getLoad(); }
+    int getQualityTier() const { return appliedQualityTier.load(); }
+
+    // Deadline statistics since the last reset, readable from any thread.
+    CallbackStats::Snapshot getCallbackStats() const { return callbackStats.snapshot(); }
+    void resetCallbackStats() { callbackStats.requestReset(); }
+
+    // Binary event log written in the background; decode with Tools/fdn_flight_decode.
+    // Off by default (or FDN_FLIGHT_LOG=1 in the environment). Message thread only.
+    void setFlightLogEnabled(bool shouldRecord);
+    bool isFlightLogEnabled() const { return flightLogEnabled; }
+    juce::File getFlightLogFile() const { return flightLogFile; }
+
+    // Measured EDT / T20 / T30 of the current settings, rendered in the
+    // background while enabled. Message thread only.
+    void setDecayAnalysisEnabled(bool shouldAnalyse);
+    const DecayAnalyzer::Result& getMeasuredDecay() {
+        decayAnalyzer.poll();
+        return decayAnalyzer.latest();
+    }
+
+    // Per-stage cost; only valid in FDN_PROFILE builds. Message thread only.
+    StageProfiler::Breakdown getStageProfile() { return fdnEngine.getStageProfile(); }
 
 private:
     FDNEngine fdnEngine;
@@ -165,10 +160,46 @@ private:
     int storedBlockSize = 512;
     float storedDspSampleRate = 48000.0f;
     int lastQualityFactor = 0;
+    int reportedPipelineLatency = 0; // engine samples
     bool forceUpdate = true;
     std::atomic<bool> panicTriggered{ false };
 
     PhysicsState lastPhysicsState{};
+    std::array<VelvetDiffuser::Tables, 3> velvetTables; // per oversampling factor
+    PhysicsParams lastPhysicsParams{};
+
+    DecayAnalyzer decayAnalyzer;
+    std::atomic<bool> decayRequestPending{ false };
+
+    void updateLatency();
+
+    // The multi-core and pipeline threads only exist while their parameter
+    // is on. They are started from prepareToPlay and, when a parameter is
+    // switched on during playback, from the timer on the message thread;
+    // turning one off only stops using them until releaseResources.
+    void startEnabledWorkers();
+    void timerCallback() override;
+    std::mutex workerLock;            // start/stop, never taken on the audio thread
+    int workerMaxLatency = 0;         // engine samples; 0 while released
+
+    // Out: wet faded out, tier applies next block. Hold: applied, wet held
+    // silent while the pipeline flushes the old stages.
+    enum class TierFade { None, Out, Hold };
+    LoadGovernor governor;
+    CallbackStats callbackStats;
+
+    FDNFlight::Recorder flightRecorder;
+    juce::File flightLogFile;
+    bool flightLogEnabled = false;
+    void recordPhysicsChanges(const PhysicsState& before, const PhysicsState& after);
+    TierFade tierFade = TierFade::None;
+    int activeTier = 0;
+    int pendingTier = 0;
+    std::atomic<int> appliedQualityTier{ 0 };
+
+    TripleBuffer<AnalysisSnapshot> analysis;
+    uint64_t analysisSequence = 0;
+    void publishAnalysis(const juce::AudioBuffer<float>& buffer);
 
     // Parameter Pointers (Fast Access)
     std::atomic<float>* widthParam = nullptr;
@@ -195,10 +226,17 @@ private:
     std::atomic<float>* heightSourceParam = nullptr;
     std::atomic<float>* shapeParam = nullptr;
     std::atomic<float>* diffParam = nullptr;
+    std::atomic<float>* diffLengthParam = nullptr;
+    std::atomic<float>* erOrderParam = nullptr;
     std::atomic<float>* widthStereoParam = nullptr;
     std::atomic<float>* levelParam = nullptr;
 
     std::atomic<float>* qualityParam = nullptr;
+    std::atomic<float>* multicoreParam = nullptr;
+    std::atomic<float>* pipelineParam = nullptr;
+    std::atomic<float>* autoQualityParam = nullptr;
+    std::atomic<float>* autoQualityDownParam = nullptr;
+    std::atomic<float>* autoQualityUpParam = nullptr;
     std::atomic<float>* driveParam = nullptr;
     std::atomic<float>* densityParam = nullptr;
     std::atomic<float>* decayParam = nullptr;
@@ -0,0 +1,20 @@
+/*
+  ==============================================================================
+    fdn_air_table_test.cpp
+    The bilinear air absorption table must stay within MAX_ERROR_DB of
+    calcAirAttenuationDb. build() asserts the same, but only where NDEBUG
+    is not defined, and the CMake build is Release by default.
+  ==============================================================================
+*/
+#include "FDN_DSP.h"
+#include <cstdio>
+
+int main() {
+    const auto table = AirAbsorptionTable::shared();
+    std::printf("air table max error %g dB (limit %g dB)\n", table->maxErrorDb, AirAbsorptionTable::MAX_ERROR_DB);
+    if (!(table->maxErrorDb <= AirAbsorptionTable::MAX_ERROR_DB)) {
+        std::printf("FAIL: air table error too large\n");
+        return 1;
+    }
+    return 0;
+}
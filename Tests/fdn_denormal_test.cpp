@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+    fdn_denormal_test.cpp
+    A decaying tail must not slow FDNEngine::process down. Renders a short
+    noise burst into a small, dead room and then silence until the tail is
+    far below the level where its state would go subnormal, with the calling
+    thread's FP mode left at the default (no FTZ/DAZ), as a host without
+    ScopedNoDenormals would. Fails if any output sample is subnormal, if the
+    tail never gets that low, or if late blocks are much slower than early
+    ones. Without ScopedFlushDenormals the late blocks run ~25x slower.
+  ==============================================================================
+*/
+#include "FDN_DSP.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static constexpr double SAMPLE_RATE = 48000.0;
+static constexpr int BLOCK = 512;
+static constexpr double TAIL_SECONDS = 15.0;
+static constexpr double MAX_SLOWDOWN = 3.0; // late / early median block time
+static constexpr float DEEP_TAIL = 1.0e-30f; // peak of the last second; the loop state is ~1e-8 of it
+
+static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    return v.empty() ? 0.0 : v[v.size() / 2];
+}
+
+int main() {
+    static FDNEngine engine; // ~30 MB of delay lines
+    engine.setSynchronousERSolve(true);
+    engine.prepare(SAMPLE_RATE);
+    PhysicsParams p;
+    p.width = 4.0f; p.depth = 5.0f; p.height = 3.0f;
+    p.absorption = 1.0f;
+    p.decay = 0.05f;
+    p.dryWet = 1.0f;
+    p.sourceDist = 2.5f; p.sourceHeight = 1.5f;
+    engine.updatePhysics(p, BLOCK);
+
+    std::vector<float> left(BLOCK), right(BLOCK);
+    float* io[] = { left.data(), right.data() };
+    std::minstd_rand rng(1);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+
+    const int burstBlocks = (int)(0.1 * SAMPLE_RATE) / BLOCK;
+    const int totalBlocks = (int)(TAIL_SECONDS * SAMPLE_RATE) / BLOCK;
+    std::vector<double> blockMicros;
+    long subnormals = 0;
+    float lastPeak = 0.0f; // of the last second
+    const int second = (int)(SAMPLE_RATE / BLOCK);
+    for (int b = 0; b < totalBlocks; ++b) {
+        for (int i = 0; i < BLOCK; ++i) {
+            left[(size_t)i] = (b < burstBlocks) ? noise(rng) : 0.0f;
+            right[(size_t)i] = (b < burstBlocks) ? noise(rng) : 0.0f;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        engine.process(io, io, BLOCK, 2);
+        blockMicros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        for (int i = 0; i < BLOCK; ++i) {
+            for (float v : { left[(size_t)i], right[(size_t)i] }) {
+                if (std::fpclassify(v) == FP_SUBNORMAL) ++subnormals;
+                if (b >= totalBlocks - second) lastPeak = std::max(lastPeak, std::abs(v));
+            }
+        }
+    }
+
+    const std::vector<double> early(blockMicros.begin() + burstBlocks, blockMicros.begin() + burstBlocks + second);
+    const std::vector<double> late(blockMicros.end() - second, blockMicros.end());
+    const double earlyUs = median(early), lateUs = median(late);
+    std::printf("early %.1f us/block, late %.1f us/block, last second peak %g, %ld subnormal samples\n",
+        earlyUs, lateUs, lastPeak, subnormals);
+
+    bool ok = true;
+    if (subnormals != 0) { std::printf("FAIL: subnormal output\n"); ok = false; }
+    if (lastPeak > DEEP_TAIL) { std::printf("FAIL: tail still at %g; lengthen TAIL_SECONDS\n", lastPeak); ok = false; }
+    if (lateUs > earlyUs * MAX_SLOWDOWN) { std::printf("FAIL: late blocks %.1fx slower\n", lateUs / earlyUs); ok = false; }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+    fdn_flight_decode.cpp
+    Prints a flight recorder log (see Source/FDN_FlightRecorder.h) as text.
+
+    Build: c++ -std=c++17 -O2 -I../Source fdn_flight_decode.cpp -o fdn_flight_decode
+    Usage: fdn_flight_decode <flight.fdnlog> [more logs...]
+  ==============================================================================
+*/
+#include "FDN_FlightRecorder.h"
+#include <cstdio>
+#include <ctime>
+
+using namespace FDNFlight;
+
+// Offsets are from the first event in the file.
+static void printTime(const FileHeader& header, const Event& e, uint64_t firstNs) {
+    const int64_t wallNs = header.wallClockNs + (int64_t)(e.timeNs - header.steadyNs);
+    const std::time_t seconds = (std::time_t)(wallNs / 1000000000);
+    const int micros = (int)((wallNs % 1000000000) / 1000);
+    std::tm utc{};
+#if defined(_WIN32)
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &utc);
+    std::printf("%s.%06d  +%10.6f s  ", text, micros, (double)(e.timeNs - firstNs) * 1.0e-9);
+}
+
+static void printEvent(const Event& e) {
+    switch (e.type) {
+    case CallbackOverrun: std::printf("callback overrun: %.3f ms of %.3f ms\n", e.a, e.b); break;
+    case PhysicsUpdate:   std::printf("updatePhysics: %.1f us\n", e.a); break;
+    case ParamChange:     std::printf("%s: %g -> %g\n", physicsFieldName(e.code), e.a, e.b); break;
+    case QualitySwitch:   std::printf("quality: %gx -> %gx (auto tier %d)\n", e.a, e.b, (int)e.code); break;
+    case Panic:           std::printf("panic reset\n"); break;
+    case Prepare:         std::printf("prepare: %g Hz, %g samples\n", e.a, e.b); break;
+    case Release:         std::printf("release\n"); break;
+    case Dropped:         std::printf("ring full: %.0f events dropped so far\n", e.a); break;
+    default:              std::printf("unknown event %d (code %d, %g, %g)\n", (int)e.type, (int)e.code, e.a, e.b); break;
+    }
+}
+
+static bool decode(const char* path) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (f == nullptr) {
+        std::fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    FileHeader header;
+    const FileHeader expected;
+    if (std::fread(&header, sizeof(header), 1, f) != 1
+        || std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0
+        || header.eventSize != sizeof(Event)) {
+        std::fprintf(stderr, "%s: not a flight recorder log\n", path);
+        std::fclose(f);
+        return false;
+    }
+    std::printf("== %s (format %u)\n", path, header.version);
+    Event e;
+    uint64_t firstNs = 0;
+    while (std::fread(&e, sizeof(e), 1, f) == 1) {
+        if (firstNs == 0) firstNs = e.timeNs;
+        printTime(header, e, firstNs);
+        printEvent(e);
+    }
+    std::fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <flight.fdnlog> [more logs...]\n", argv[0]);
+        return 2;
+    }
+    bool ok = true;
+    for (int i = 1; i < argc; ++i) ok = decode(argv[i]) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+    fdn_render.cpp
+    Renders audio through the engine library without JUCE, and reports how
+    fast it ran. Without --in the input is a unit impulse, so --out gives
+    the impulse response of the settings.
+
+    Build: cmake -S . -B build && cmake --build build --target fdn_render
+    Usage: fdn_render [options]
+      --rate <Hz>            sample rate (48000)
+      --block <samples>      control block size (512)
+      --seconds <s>          length without --in (10)
+      --in <file>            raw interleaved stereo float32 input
+      --out <file>           raw interleaved stereo float32 output
+      --set <name>=<value>   change one setting; repeatable, see --list
+      --multicore            run the line groups on worker threads
+      --adaa                 anti-aliased (ADAA) drive in the loop
+      --list                 print the settings and their defaults
+  ==============================================================================
+*/
+#include "FDN_Engine.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace FDNReverb;
+
+static void usage(const char* program) {
+    std::fprintf(stderr, "usage: %s [--rate Hz] [--block n] [--seconds s] [--in file] [--out file]\n"
+        "       [--set name=value]... [--multicore] [--adaa] [--list]\n", program);
+}
+
+static bool readInput(const char* path, std::vector<float>& left, std::vector<float>& right) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (f == nullptr) return false;
+    float frame[2];
+    while (std::fread(frame, sizeof(frame), 1, f) == 1) {
+        left.push_back(frame[0]);
+        right.push_back(frame[1]);
+    }
+    std::fclose(f);
+    return true;
+}
+
+static bool writeOutput(const char* path, const std::vector<float>& left, const std::vector<float>& right) {
+    std::FILE* f = std::fopen(path, "wb");
+    if (f == nullptr) return false;
+    for (size_t i = 0; i < left.size(); ++i) {
+        const float frame[2] = { left[i], right[i] };
+        std::fwrite(frame, sizeof(frame), 1, f);
+    }
+    return std::fclose(f) == 0;
+}
+
+int main(int argc, char** argv) {
+    Engine::Options options;
+    std::vector<ParameterChange> changes;
+    double seconds = 10.0;
+    const char* inPath = nullptr;
+    const char* outPath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--rate" && hasValue) options.sampleRate = std::atof(argv[++i]);
+        else if (arg == "--block" && hasValue) options.blockSize = std::atoi(argv[++i]);
+        else if (arg == "--seconds" && hasValue) seconds = std::atof(argv[++i]);
+        else if (arg == "--in" && hasValue) inPath = argv[++i];
+        else if (arg == "--out" && hasValue) outPath = argv[++i];
+        else if (arg == "--multicore") options.multiCore = true;
+        else if (arg == "--adaa") options.driveAntialiasing = true;
+        else if (arg == "--set" && hasValue) {
+            const std::string assignment = argv[++i];
+            const size_t eq = assignment.find('=');
+            ParameterChange change;
+            if (eq == std::string::npos || !findParam(assignment.substr(0, eq), change.param)) {
+                std::fprintf(stderr, "unknown setting: %s (see --list)\n", assignment.c_str());
+                return 2;
+            }
+            change.value = (float)std::atof(assignment.c_str() + eq + 1);
+            changes.push_back(change);
+        }
+        else if (arg == "--list") {
+            const Engine engine;
+            for (int k = 0; k < (int)Param::Count; ++k)
+                std::printf("%-14s %g\n", paramName((Param)k), engine.getParameter((Param)k));
+            return 0;
+        }
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (options.sampleRate < 8000.0 || options.blockSize < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<float> left, right;
+    if (inPath != nullptr) {
+        if (!readInput(inPath, left, right)) {
+            std::fprintf(stderr, "%s: cannot open\n", inPath);
+            return 1;
+        }
+    }
+    else {
+        left.assign((size_t)(seconds * options.sampleRate), 0.0f);
+        right.assign(left.size(), 0.0f);
+        if (!left.empty()) left[0] = right[0] = 1.0f;
+    }
+
+    Engine engine(options);
+    const auto start = std::chrono::steady_clock::now();
+    engine.processBatch(left.data(), right.data(), left.data(), right.data(), (int64_t)left.size(),
+        changes.data(), changes.size());
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double rendered = (double)left.size() / options.sampleRate;
+    std::fprintf(stderr, "rendered %.2f s in %.3f s (%.1fx realtime, %.1f ns/sample)\n",
+        rendered, elapsed, elapsed > 0.0 ? rendered / elapsed : 0.0,
+        left.empty() ? 0.0 : elapsed * 1.0e9 / (double)left.size());
+
+    if (outPath != nullptr && !writeOutput(outPath, left, right)) {
+        std::fprintf(stderr, "%s: cannot write\n", outPath);
+        return 1;
+    }
+    return 0;
+}